@@ -0,0 +1,36 @@
+/// @file bench_duration.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Measures the conversion of a Duration to a string, in each print mode.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+/// Try: timelib_bench_duration --output=duration.json
+
+#include "timelib/duration.hpp"
+#include "timelib/registry.hpp"
+
+#include <string>
+
+/// @brief An hour, four minutes and a few fractions, so every field of the output is printed.
+static const timelib::timespec_t elapsed(3842, 153399001);
+
+/// @brief Converts the duration to a string in the given mode.
+/// @param print_mode the print mode.
+/// @param format the format, used by the custom mode.
+static void to_string(timelib::print_mode_t print_mode, const std::string &format = std::string())
+{
+    timelib::Duration duration(elapsed, print_mode, format);
+    timelib::do_not_optimize(duration);
+    std::string result = duration.to_string();
+    timelib::do_not_optimize(result);
+}
+
+TIMELIB_BENCHMARK(duration_to_string_human) { to_string(timelib::human); }
+
+TIMELIB_BENCHMARK(duration_to_string_numeric) { to_string(timelib::numeric); }
+
+TIMELIB_BENCHMARK(duration_to_string_total) { to_string(timelib::total); }
+
+TIMELIB_BENCHMARK(duration_to_string_custom) { to_string(timelib::custom, "%H:%M:%s.%m.%u.%n"); }
+
+TIMELIB_MAIN()
@@ -0,0 +1,44 @@
+/// @file bench_stopwatch.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Measures taking the rounds of a Stopwatch.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+/// Try: timelib_bench_stopwatch --output=stopwatch.json
+
+#include "timelib/registry.hpp"
+#include "timelib/stopwatch.hpp"
+
+#include <cstddef>
+
+/// @brief The number of rounds kept before the stopwatch is reset, which
+/// bounds its memory while still including the growth of the partials.
+static const std::size_t rounds_per_reset = 1024;
+
+/// @brief Takes a round of a stopwatch shared by all the iterations.
+/// @param items the items processed in the round, zero to use the plain round().
+static void take_round(std::size_t items)
+{
+    static timelib::Stopwatch stopwatch;
+    static std::size_t rounds = 0;
+    if (++rounds == rounds_per_reset) {
+        stopwatch.reset();
+        rounds = 0;
+    }
+    timelib::Duration partial = (items > 0) ? stopwatch.round(items) : stopwatch.round();
+    timelib::do_not_optimize(partial);
+}
+
+TIMELIB_BENCHMARK(stopwatch_round) { take_round(0); }
+
+TIMELIB_BENCHMARK(stopwatch_round_items) { take_round(64); }
+
+TIMELIB_BENCHMARK(stopwatch_start_round)
+{
+    timelib::Stopwatch stopwatch;
+    stopwatch.start();
+    timelib::Duration partial = stopwatch.round();
+    timelib::do_not_optimize(partial);
+}
+
+TIMELIB_MAIN()
@@ -0,0 +1,50 @@
+/// @file bench_timer.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Measures the timeout check and the elapsed time of a Timer.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+/// Try: timelib_bench_timer --output=timer.json
+
+#include "timelib/registry.hpp"
+#include "timelib/timer.hpp"
+
+/// @brief Returns a timer, started once, whose timeout is far in the future.
+/// @return a reference to the timer.
+static auto pending_timer() -> const timelib::Timer &
+{
+    static timelib::Timer timer = [] {
+        timelib::Timer result;
+        result.set_timeout(3600.);
+        return result;
+    }();
+    return timer;
+}
+
+/// @brief Returns a timer without timeout, which skips reading the clock.
+/// @return a reference to the timer.
+static auto unset_timer() -> const timelib::Timer &
+{
+    static timelib::Timer timer;
+    return timer;
+}
+
+TIMELIB_BENCHMARK(timer_has_timeout)
+{
+    bool result = pending_timer().has_timeout();
+    timelib::do_not_optimize(result);
+}
+
+TIMELIB_BENCHMARK(timer_has_timeout_unset)
+{
+    bool result = unset_timer().has_timeout();
+    timelib::do_not_optimize(result);
+}
+
+TIMELIB_BENCHMARK(timer_elapsed)
+{
+    timelib::Duration elapsed = pending_timer().elapsed();
+    timelib::do_not_optimize(elapsed);
+}
+
+TIMELIB_MAIN()
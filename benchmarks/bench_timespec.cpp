@@ -0,0 +1,75 @@
+/// @file bench_timespec.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Measures reading the clock, and the arithmetic and comparison operators of timespec_t.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+/// Try: timelib_bench_timespec --output=timespec.json
+
+#include "timelib/registry.hpp"
+#include "timelib/timespec.hpp"
+
+/// @brief The operands of the operators, read through do_not_optimize so they are not folded.
+static timelib::timespec_t lhs(12, 345678901);
+static timelib::timespec_t rhs(3, 987654321);
+
+TIMELIB_BENCHMARK(timespec_now)
+{
+    timelib::timespec_t now = timelib::timespec_t::now();
+    timelib::do_not_optimize(now);
+}
+
+TIMELIB_BENCHMARK(timespec_add)
+{
+    timelib::do_not_optimize(lhs);
+    timelib::do_not_optimize(rhs);
+    timelib::timespec_t result = lhs + rhs;
+    timelib::do_not_optimize(result);
+}
+
+TIMELIB_BENCHMARK(timespec_subtract)
+{
+    timelib::do_not_optimize(lhs);
+    timelib::do_not_optimize(rhs);
+    timelib::timespec_t result = lhs - rhs;
+    timelib::do_not_optimize(result);
+}
+
+TIMELIB_BENCHMARK(timespec_multiply_scalar)
+{
+    timelib::do_not_optimize(lhs);
+    timelib::timespec_t result = lhs * 1.5;
+    timelib::do_not_optimize(result);
+}
+
+TIMELIB_BENCHMARK(timespec_divide_scalar)
+{
+    timelib::do_not_optimize(lhs);
+    timelib::timespec_t result = lhs / 3.;
+    timelib::do_not_optimize(result);
+}
+
+TIMELIB_BENCHMARK(timespec_add_assign)
+{
+    timelib::timespec_t result = lhs;
+    timelib::do_not_optimize(result);
+    result += rhs;
+    timelib::do_not_optimize(result);
+}
+
+TIMELIB_BENCHMARK(timespec_compare)
+{
+    timelib::do_not_optimize(lhs);
+    timelib::do_not_optimize(rhs);
+    bool result = (lhs < rhs) || (lhs == rhs);
+    timelib::do_not_optimize(result);
+}
+
+TIMELIB_BENCHMARK(timespec_count)
+{
+    timelib::do_not_optimize(lhs);
+    double result = lhs.count();
+    timelib::do_not_optimize(result);
+}
+
+TIMELIB_MAIN()
@@ -0,0 +1,37 @@
+/// @file example_batch.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief An example on how to time nanosecond-scale functions in batches.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/batch.hpp"
+#include "timelib/io.hpp"
+
+#include <cmath>
+#include <iostream>
+
+int main(int, char *[])
+{
+    timelib::clock_info_t clock = timelib::measure_clock();
+    std::cout << "Clock overhead   : " << timelib::detail::format_time(clock.overhead) << "\n";
+    std::cout << "Clock resolution : " << timelib::detail::format_time(clock.resolution) << "\n";
+
+    auto square_root = [] {
+        double value = 2.;
+        timelib::do_not_optimize(value);
+        return std::sqrt(value);
+    };
+
+    // Reading the clock around every call measures mostly the clock.
+    timelib::Stopwatch stopwatch;
+    timelib::ntimes<1000>(stopwatch, square_root);
+    std::cout << "ntimes           : " << stopwatch.mean() << "\n";
+
+    // Reading the clock once per batch amortizes its cost.
+    timelib::batch_result_t result = timelib::ntimes_batched<100>(stopwatch, square_root);
+    std::cout << "ntimes_batched   : " << result << "\n";
+    timelib::confidence_interval_t<double> interval = result.confidence_interval();
+    std::cout << "95% interval     : [" << timelib::detail::format_time(interval.lower) << ", "
+              << timelib::detail::format_time(interval.upper) << "]\n";
+    return 0;
+}
@@ -0,0 +1,77 @@
+/// @file example_benchmark.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief A couple of examples on how to use the benchmark runner.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/benchmark.hpp"
+#include "timelib/report.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+inline std::vector<double> generate_random_values(unsigned size)
+{
+    std::vector<double> values(size);
+    std::uniform_real_distribution<double> dist(-100, +100);
+    std::default_random_engine eng;
+    for (std::size_t i = 0; i < values.size(); ++i)
+        values[i] = dist(eng);
+    return values;
+}
+
+inline double compute_mean(const std::vector<double> &values)
+{
+    double mean = 0.;
+    for (std::size_t i = 0; i < values.size(); ++i)
+        mean += values[i];
+    return mean / static_cast<double>(values.size());
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<double> values;
+
+    timelib::report_t report;
+    report.environment = timelib::capture_environment();
+
+    timelib::benchmark_options_t options;
+    options.warmup_time = 0.05;
+    options.min_time    = 0.1;
+    options.repetitions = 5;
+    // Pin the measuring thread, to avoid migrations between cores.
+    options.isolation.pin = true;
+
+    timelib::Benchmark generate("generate", options);
+    report.results.push_back(generate.run([&] { values = generate_random_values(1000); }));
+    std::cout << report.results.back() << "\n";
+
+    timelib::Benchmark average("mean", options);
+    timelib::benchmark_result_t result = average.run([&] { return compute_mean(values); });
+    std::cout << result << "\n";
+    std::cout << result.summary() << "\n";
+    report.results.push_back(result);
+
+    // Keep a pure computation alive explicitly.
+    timelib::Benchmark square_root("sqrt", options);
+    report.results.push_back(square_root.run([&] {
+        double value = 2.;
+        timelib::do_not_optimize(value);
+        value = std::sqrt(value);
+        timelib::do_not_optimize(value);
+    }));
+    std::cout << report.results.back() << "\n";
+
+    // Save the results, which can be compared later with `timelib_compare`.
+    if (argc > 1) {
+        std::string path(argv[1]);
+        bool is_csv = (path.size() > 4) && (path.compare(path.size() - 4, 4, ".csv") == 0);
+        report.save(path, is_csv ? timelib::csv : timelib::json);
+        std::cout << "Results saved to " << path << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,38 @@
+/// @file example_cache.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief An example on how to measure a function with cold and with warm caches.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/cache.hpp"
+
+#include <iostream>
+#include <vector>
+
+int main(int, char *[])
+{
+    std::cout << "Last level cache : " << (timelib::last_level_cache_size() / 1024) << " KiB\n\n";
+
+    // A working set which fits in the caches.
+    std::vector<int> values(64 * 1024, 1);
+    auto sum = [&values] {
+        long result = 0;
+        for (int value : values) {
+            result += value;
+        }
+        timelib::do_not_optimize(result);
+    };
+
+    // Evict everything, by writing a buffer larger than the last level cache.
+    timelib::cache_options_t options;
+    options.samples = 20;
+    std::cout << timelib::measure_cache("sum/buffer", sum, options) << "\n";
+
+    // Flush only the working set, which is much faster.
+    options.samples          = 100;
+    options.eviction         = timelib::eviction_flush;
+    options.working_set      = values.data();
+    options.working_set_size = values.size() * sizeof(int);
+    std::cout << timelib::measure_cache("sum/flush", sum, options);
+    return 0;
+}
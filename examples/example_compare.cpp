@@ -0,0 +1,36 @@
+/// @file example_compare.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief An example on how to compare two implementations.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/compare.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+int main(int, char *[])
+{
+    std::vector<int> values(4096);
+    std::iota(values.begin(), values.end(), 0);
+    std::reverse(values.begin(), values.end());
+
+    timelib::comparison_options_t options;
+    options.benchmark.warmup_time = 0.02;
+    options.benchmark.min_time    = 0.02;
+    options.benchmark.repetitions = 15;
+
+    // Linear search against binary search on sorted data.
+    std::vector<int> sorted(values);
+    std::sort(sorted.begin(), sorted.end());
+
+    timelib::comparison_t comparison = timelib::compare(
+        "linear", [&] { return std::find(values.begin(), values.end(), 1000) != values.end(); }, //
+        "binary", [&] { return std::binary_search(sorted.begin(), sorted.end(), 1000); },        //
+        options);
+
+    std::cout << comparison << "\n";
+    return 0;
+}
@@ -0,0 +1,62 @@
+/// @file example_complexity.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief An example on how to fit the complexity of parameterized benchmarks.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/complexity.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+inline std::vector<int> generate_random_values(std::size_t size)
+{
+    std::vector<int> values(size);
+    std::uniform_int_distribution<int> dist(0, 1000000);
+    std::default_random_engine eng;
+    for (std::size_t i = 0; i < values.size(); ++i)
+        values[i] = dist(eng);
+    return values;
+}
+
+int main(int, char *[])
+{
+    timelib::benchmark_options_t options;
+    options.warmup_time = 0.01;
+    options.min_time    = 0.02;
+    options.repetitions = 3;
+
+    // Summing is linear in the number of elements.
+    timelib::ParameterizedBenchmark accumulate("accumulate", timelib::geometric_range(1024, 262144, 4), options);
+    std::cout << accumulate.run([](std::size_t n) {
+        std::vector<int> values = generate_random_values(n);
+        return [values]() { return std::accumulate(values.begin(), values.end(), 0); };
+    }) << "\n";
+
+    // Looking up a value in a balanced tree is logarithmic.
+    timelib::ParameterizedBenchmark lookup("set::find", timelib::geometric_range(1024, 262144, 4), options);
+    std::cout << lookup.run([](std::size_t n) {
+        std::vector<int> values = generate_random_values(n);
+        std::set<int> tree(values.begin(), values.end());
+        return [tree]() { return tree.find(500000) != tree.end(); };
+    }) << "\n";
+
+    // Sorting a copy is linearithmic (plus the linear copy).
+    timelib::ParameterizedBenchmark sort("sort", timelib::geometric_range(1024, 65536, 4), options);
+    timelib::parameterized_result_t result = sort.run([](std::size_t n) {
+        std::vector<int> values = generate_random_values(n);
+        return [values]() {
+            std::vector<int> copy(values);
+            std::sort(copy.begin(), copy.end());
+            return copy.front();
+        };
+    });
+    std::cout << result << "\n";
+    std::cout << "sort is " << timelib::to_string(result.best_fit().complexity) << "\n";
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+/// @file example_counters.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief An example on how to read performance counters around timed regions.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/counters.hpp"
+#include "timelib/io.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+int main(int, char *[])
+{
+    timelib::CounterGroup counters;
+    for (unsigned i = 0; i < timelib::event_count; ++i) {
+        auto event = static_cast<timelib::counter_event_t>(i);
+        std::cout << timelib::to_string(event) << ": " << (counters.available(event) ? "yes" : "no") << "\n";
+    }
+
+    // Sequential accesses, friendly to the caches and the branch predictor.
+    std::vector<unsigned> values(1 << 20);
+    std::iota(values.begin(), values.end(), 0U);
+    timelib::Stopwatch stopwatch;
+    timelib::time(stopwatch, counters, [&] { return std::accumulate(values.begin(), values.end(), 0UL); });
+    std::cout << "sequential : " << stopwatch.last_round() << ", " << counters.rounds().back() << "\n";
+
+    // Random accesses, which miss the caches.
+    std::vector<unsigned> indices(values.size());
+    std::iota(indices.begin(), indices.end(), 0U);
+    std::shuffle(indices.begin(), indices.end(), std::default_random_engine());
+    timelib::time(stopwatch, counters, [&] {
+        unsigned long sum = 0;
+        for (unsigned index : indices)
+            sum += values[index];
+        return sum;
+    });
+    std::cout << "random     : " << stopwatch.last_round() << ", " << counters.rounds().back() << "\n";
+
+    // Touching fresh memory causes page faults.
+    timelib::ntimes<3>(stopwatch, counters, [] { return std::vector<char>(1 << 22, 1).back(); });
+    std::cout << "allocation : " << stopwatch.mean() << ", " << counters.mean() << "\n";
+    return 0;
+}
@@ -0,0 +1,85 @@
+/// @file example_deadline.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief A couple of examples on how to wait with deadlines.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/deadline.hpp"
+#include "timelib/io.hpp"
+
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+int main(int, char *[])
+{
+    using namespace timelib;
+
+    // Example 1: Waiting on a condition variable with a deadline.
+    {
+        std::cout << "Example 1: Waiting on a condition variable...\n";
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool ready = false;
+
+        // The deadline is computed once, before waiting.
+        Deadline deadline = Deadline::after(timespec_t(1.0));
+
+        std::thread producer([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            std::lock_guard<std::mutex> guard(mutex);
+            ready = true;
+            condition.notify_one();
+        });
+
+        std::unique_lock<std::mutex> lock(mutex);
+        bool result = wait_until(condition, lock, deadline, [&] { return ready; });
+        lock.unlock();
+        producer.join();
+
+        std::cout << "Ready before the deadline : " << result << "\n";
+        std::cout << "Time left                 : " << deadline.remaining() << "\n";
+    }
+
+    // Example 2: Waiting on a future with the timeout of a timer.
+    {
+        std::cout << "\nExample 2: Waiting on a future...\n";
+
+        Timer timer;
+        timer.set_timeout(0.1);
+        timer.start();
+
+        std::future<int> future = std::async(std::launch::async, [] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            return 42;
+        });
+
+        bool result = wait_until(future, Deadline::from_timer(timer));
+        std::cout << "Ready before the timeout  : " << result << "\n";
+        std::cout << "Timer has timeout         : " << timer.has_timeout() << "\n";
+        std::cout << "Value                     : " << future.get() << "\n";
+    }
+
+    // Example 3: Waiting on a futex word.
+    {
+        std::cout << "\nExample 3: Waiting on a futex word...\n";
+
+        std::atomic<int> word(0);
+
+        std::thread producer([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            word.store(1, std::memory_order_release);
+            futex_wake(word);
+        });
+
+        bool result = futex_wait_until(word, 0, Deadline::after(timespec_t(1.0)));
+        producer.join();
+
+        std::cout << "Word changed              : " << result << "\n";
+        std::cout << "Expired wait              : "
+                  << futex_wait_until(word, 1, Deadline::after(timespec_t(0.05))) << "\n";
+    }
+
+    return 0;
+}
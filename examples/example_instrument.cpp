@@ -0,0 +1,60 @@
+/// @file example_instrument.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief An example of instrumentation left in the code, and compiled in or out by TIMELIB_LEVEL.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/instrument.hpp"
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static auto is_prime(std::size_t value) -> bool
+{
+    // Only compiled in at the verbose level, since it runs once per candidate.
+    TIMELIB_ZONE(TIMELIB_LEVEL_VERBOSE);
+    for (std::size_t divisor = 2; divisor * divisor <= value; ++divisor) {
+        TIMELIB_COUNTER(TIMELIB_LEVEL_VERBOSE, "divisions", 1);
+        if ((value % divisor) == 0) {
+            return false;
+        }
+    }
+    return value > 1;
+}
+
+static void find_primes(std::size_t limit, std::vector<std::size_t> &primes)
+{
+    TIMELIB_ZONE(TIMELIB_LEVEL_FINE);
+    primes.clear();
+    for (std::size_t value = 0; value < limit; ++value) {
+        if (is_prime(value)) {
+            primes.push_back(value);
+        }
+    }
+    TIMELIB_COUNTER(TIMELIB_LEVEL_FINE, "primes", primes.size());
+}
+
+int main(int, char *[])
+{
+    std::size_t found = 0;
+    {
+        TIMELIB_SCOPED_TIMER(TIMELIB_LEVEL_COARSE, "search");
+        // The vector is reused by all the rounds, which keep its allocation.
+        std::vector<std::size_t> primes;
+        for (std::size_t round = 0; round < 10; ++round) {
+            find_primes(20000, primes);
+            found += primes.size();
+        }
+    }
+    std::cout << "Found " << found << " primes, with TIMELIB_LEVEL " << TIMELIB_LEVEL << ".\n";
+
+    std::string probes = timelib::probes_to_string();
+    if (probes.empty()) {
+        std::cout << "The instrumentation is compiled out, configure with -DTIMELIB_LEVEL=1 (or 2, 3) to see it.\n";
+    } else {
+        std::cout << "\n" << probes;
+    }
+    return 0;
+}
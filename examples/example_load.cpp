@@ -0,0 +1,35 @@
+/// @file example_load.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief An example on how to measure the latency of a request handler under a fixed arrival rate.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/load.hpp"
+
+#include <iostream>
+
+int main(int, char *[])
+{
+    // A request handler which keeps the processor busy for about 50us.
+    auto handler = [] {
+        auto start = timelib::detail::load_clock_t::now();
+        while (timelib::detail::seconds_between(start, timelib::detail::load_clock_t::now()) < 50e-6) {
+            // Busy wait.
+        }
+    };
+
+    timelib::load_options_t options;
+    options.duration = 0.5;
+    timelib::LoadGenerator generator("handler", options);
+
+    // Double the rate until the handler cannot keep up.
+    timelib::load_sweep_t sweep = generator.saturate(handler, 1000.);
+    std::cout << sweep << "\n";
+
+    // Then, look at the latency at 80% of the saturation.
+    double rate = 0.8 * sweep.max_sustainable_rate();
+    if (rate > 0.) {
+        std::cout << generator.run(handler, rate);
+    }
+    return 0;
+}
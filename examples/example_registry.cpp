@@ -0,0 +1,54 @@
+/// @file example_registry.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief An example on how to register benchmarks, and run them from the command line.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+/// Try: timelib_example_registry --list
+///      timelib_example_registry --filter=sort --repetitions=3 --format=json
+
+#include "timelib/registry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+TIMELIB_BENCHMARK(square_root)
+{
+    double value = 2.;
+    timelib::do_not_optimize(value);
+    double result = std::sqrt(value);
+    timelib::do_not_optimize(result);
+}
+
+TIMELIB_BENCHMARK(sort_small)
+{
+    std::vector<int> values = {5, 3, 9, 1, 7, 2, 8, 6, 4, 0};
+    std::sort(values.begin(), values.end());
+    timelib::do_not_optimize(values);
+}
+
+TIMELIB_BENCHMARK(sort_large)
+{
+    std::vector<int> values(1000);
+    std::iota(values.rbegin(), values.rend(), 0);
+    std::sort(values.begin(), values.end());
+    timelib::do_not_optimize(values);
+}
+
+// Benchmarks can also be registered from code, with their own options.
+static const bool registered_accumulate = [] {
+    timelib::benchmark_options_t options;
+    options.items_per_iteration = 1000;
+    return timelib::register_benchmark(
+        "accumulate",
+        [] {
+            std::vector<int> values(1000, 1);
+            int sum = std::accumulate(values.begin(), values.end(), 0);
+            timelib::do_not_optimize(sum);
+        },
+        options);
+}();
+
+TIMELIB_MAIN()
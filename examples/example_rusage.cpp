@@ -0,0 +1,31 @@
+/// @file example_rusage.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief An example on how to track the resource usage of measured regions.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/io.hpp"
+#include "timelib/rusage.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+int main(int, char *[])
+{
+    timelib::Stopwatch stopwatch;
+    timelib::ResourceTracker tracker;
+
+    // Touching fresh memory causes minor page faults.
+    timelib::ntimes<3>(stopwatch, tracker, [] { return std::vector<char>(1 << 22, 1).back(); });
+    for (std::size_t i = 0; i < tracker.rounds().size(); ++i) {
+        std::cout << stopwatch.partials()[i] << " : " << tracker.rounds()[i] << "\n";
+    }
+
+    // Sleeping is a voluntary context switch, which contaminates the sample.
+    timelib::time(stopwatch, tracker, [] { std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+    std::cout << stopwatch.last_round() << " : " << tracker.rounds().back() << "\n";
+    std::cout << tracker.contaminated() << " of " << tracker.rounds().size() << " rounds contaminated\n";
+    return 0;
+}
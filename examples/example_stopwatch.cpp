@@ -4,6 +4,7 @@
 /// @copyright (c) 2024 This file is distributed under the MIT License.
 /// See LICENSE.md for details.
 
+#include "timelib/io.hpp"
 #include "timelib/stopwatch.hpp"
 
 #include <iostream>
@@ -60,7 +61,7 @@ int main(int, char *[])
     sw.set_print_mode(timelib::total);
     std::cout << "Abs      : " << sw << "\n";
 
-    timelib::time(sw, [&] { compute_mean(values); });
+    timelib::time(sw, [&] { return compute_mean(values); });
 
     sw.set_print_mode(timelib::human);
     std::cout << "Mean      : " << sw << "\n";
@@ -0,0 +1,43 @@
+/// @file example_threaded.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief An example on how to measure the scaling of a function across threads.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/threaded.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+int main(int, char *[])
+{
+    timelib::threaded_options_t options;
+    options.benchmark.warmup_time = 0.01;
+    options.benchmark.min_time    = 0.02;
+    options.benchmark.repetitions = 5;
+    options.pin                   = true;
+
+    std::vector<std::size_t> thread_counts{1, 2, 4};
+
+    // Every thread increments the same counter, so they contend for its cache line.
+    std::atomic<unsigned long> counter(0);
+    timelib::ThreadedBenchmark contended("atomic increment", options);
+    timelib::threaded_result_t result = contended.run([&] { counter.fetch_add(1, std::memory_order_relaxed); }, 2);
+    std::cout << result << "\n";
+    std::cout << contended.scale([&] { counter.fetch_add(1, std::memory_order_relaxed); }, thread_counts) << "\n";
+
+    // Independent work, which scales with the number of processors.
+    timelib::ThreadedBenchmark independent("sqrt", options);
+    std::cout << independent.scale(
+                     [] {
+                         double value = 2.;
+                         timelib::do_not_optimize(value);
+                         return std::sqrt(value);
+                     },
+                     thread_counts)
+              << "\n";
+
+    return 0;
+}
@@ -0,0 +1,45 @@
+/// @file example_throughput.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief An example on how to report the throughput of a benchmark, in items and bytes per second.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/benchmark.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+int main(int, char *[])
+{
+    const std::size_t size = 1024 * 1024;
+    std::vector<char> source(size, 'a');
+    std::vector<char> destination(size);
+
+    // With a stopwatch, each round records how much it has processed.
+    timelib::Stopwatch stopwatch;
+    for (std::size_t i = 0; i < 20; ++i) {
+        stopwatch.start();
+        char *data = destination.data();
+        std::memcpy(data, source.data(), size);
+        timelib::do_not_optimize(data);
+        (void)stopwatch.round(0, size);
+    }
+    std::cout << "memcpy   : " << timelib::compute_throughput(stopwatch, timelib::unit_bytes) << "\n";
+
+    // With a benchmark, the options state how much each iteration processes.
+    std::vector<int> values(4096, 1);
+    timelib::benchmark_options_t options;
+    options.items_per_iteration = values.size();
+    options.bytes_per_iteration = values.size() * sizeof(int);
+    timelib::Benchmark benchmark("accumulate", options);
+    timelib::benchmark_result_t result = benchmark.run([&values] {
+        long sum = 0;
+        for (int value : values) {
+            sum += value;
+        }
+        timelib::do_not_optimize(sum);
+    });
+    std::cout << result;
+    return 0;
+}
@@ -4,6 +4,7 @@
 /// @copyright (c) 2024 This file is distributed under the MIT License.
 /// See LICENSE.md for details.
 
+#include "timelib/io.hpp"
 #include "timelib/timer.hpp"
 
 #include <iostream>
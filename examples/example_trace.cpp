@@ -0,0 +1,85 @@
+/// @file example_trace.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief An example on how to trace events from several threads, through per-thread buffers.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/optimizer.hpp"
+#include "timelib/trace.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+static void work(std::size_t iterations)
+{
+    static const std::uint32_t step = timelib::register_trace_name("step");
+    double value                    = 0.;
+    for (std::size_t i = 0; i < iterations; ++i) {
+        timelib::TraceScope scope(step);
+        value += std::sqrt(static_cast<double>(i));
+    }
+    timelib::do_not_optimize(value);
+}
+
+int main(int argc, char *argv[])
+{
+    // Events go to a CSV file if one is given, and to an in-memory queue otherwise.
+    std::unique_ptr<timelib::TraceSink> sink;
+    timelib::TraceQueue *queue = nullptr;
+    try {
+        if (argc > 1) {
+            sink.reset(new timelib::TraceFile(argv[1]));
+        } else {
+            queue = new timelib::TraceQueue();
+            sink.reset(queue);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 2;
+    }
+    timelib::set_trace_sink(sink.get());
+
+    // Each worker fills its own buffer, which is flushed when full and when the worker exits.
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < 4; ++i) {
+        workers.emplace_back(work, 5000);
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    // The events of the main thread stay in its buffer until the drain.
+    work(100);
+    timelib::trace_drain();
+    timelib::set_trace_sink(nullptr);
+
+    if (queue == nullptr) {
+        std::cout << "Wrote the events to '" << argv[1] << "'.\n";
+        return 0;
+    }
+    // Pairs the begin and end events of each thread, to sum the time spent in each scope.
+    std::vector<timelib::trace_event_t> events = queue->take();
+    std::map<std::uint16_t, std::vector<std::uint64_t> > open;
+    std::map<std::uint16_t, std::pair<std::size_t, std::uint64_t> > totals;
+    for (const auto &event : events) {
+        if (event.phase == timelib::trace_begin_phase) {
+            open[event.thread].push_back(event.timestamp);
+        } else if ((event.phase == timelib::trace_end_phase) && !open[event.thread].empty()) {
+            totals[event.thread].first += 1;
+            totals[event.thread].second += event.timestamp - open[event.thread].back();
+            open[event.thread].pop_back();
+        }
+    }
+    std::cout << "Received " << events.size() << " events.\n";
+    for (const auto &total : totals) {
+        std::cout << "Thread " << total.first << ": " << total.second.first << " scopes, "
+                  << timelib::detail::format_time(static_cast<double>(total.second.second) * 1e-9) << " in total\n";
+    }
+    return 0;
+}
@@ -0,0 +1,210 @@
+/// @file batch.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the batched timing of very short functions, which amortizes the cost of reading the clock.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace timelib
+{
+
+/// @brief The properties of the clock used by the library.
+struct clock_info_t {
+    /// @brief The time needed to read the clock, in seconds.
+    double overhead;
+    /// @brief The smallest non-zero difference between two readings, in seconds.
+    double resolution;
+
+    /// @brief Returns the smallest interval that the clock can measure with
+    /// the given relative error.
+    /// @param precision the relative error (e.g., 0.001 for 0.1%).
+    /// @return the interval, in seconds.
+    auto min_interval(double precision) const -> double
+    {
+        return std::max(overhead, resolution) / precision;
+    }
+};
+
+/// @brief Measures the overhead and the resolution of the clock.
+/// @param samples the number of consecutive readings.
+/// @return the properties of the clock.
+inline auto measure_clock(std::size_t samples = 10000) -> clock_info_t
+{
+    std::vector<double> deltas;
+    deltas.reserve(samples);
+    timespec_t start    = timespec_t::now();
+    timespec_t previous = start;
+    for (std::size_t i = 0; i < samples; ++i) {
+        timespec_t current = timespec_t::now();
+        double delta       = (current - previous).count();
+        if (delta > 0.) {
+            deltas.push_back(delta);
+        }
+        previous = current;
+    }
+    clock_info_t info;
+    info.overhead   = (previous - start).count() / static_cast<double>(std::max<std::size_t>(samples, 1));
+    info.resolution = deltas.empty() ? info.overhead : *std::min_element(deltas.begin(), deltas.end());
+    return info;
+}
+
+/// @brief Chooses how many calls to time with a single pair of clock
+/// readings, so that the clock overhead and resolution become negligible.
+/// @param function the function to time.
+/// @param clock the properties of the clock.
+/// @param precision the tolerated relative error due to the clock.
+/// @param max_batch_size the upper bound to the size of a batch.
+/// @return the number of calls per batch.
+template <class Function>
+inline auto choose_batch_size(
+    const Function &function,
+    const clock_info_t &clock,
+    double precision           = 0.001,
+    std::size_t max_batch_size = 100000000UL) -> std::size_t
+{
+    double target          = clock.min_interval(precision);
+    std::size_t batch_size = 1;
+    while (batch_size < max_batch_size) {
+        timespec_t start = timespec_t::now();
+        for (std::size_t i = 0; i < batch_size; ++i) {
+            detail::invoke_opaque(function);
+        }
+        if ((timespec_t::now() - start).count() >= target) {
+            break;
+        }
+        batch_size = std::min(batch_size * 2, max_batch_size);
+    }
+    return batch_size;
+}
+
+/// @brief The results of a batched timing.
+/// @details Each sample is the mean time of the calls of a batch. If the
+/// calls are independent with variance s^2, a batch mean has variance
+/// s^2 / K, so the per-call variance is estimated as K times the variance of
+/// the batch means, and the standard error of the overall mean as the
+/// standard deviation of the batch means over the square root of their number.
+struct batch_result_t {
+    /// @brief The number of calls in each batch.
+    std::size_t batch_size;
+    /// @brief The properties of the clock used to choose the batch size.
+    clock_info_t clock;
+    /// @brief The mean time per call of each batch, in seconds.
+    std::vector<double> samples;
+    /// @brief The mean time per call of each batch of an empty function, in seconds.
+    std::vector<double> baseline;
+
+    /// @brief Returns the mean time per call.
+    /// @return the mean, in seconds.
+    auto mean() const -> double { return timelib::mean(samples); }
+
+    /// @brief Returns the estimated standard deviation of a single call.
+    /// @return the standard deviation, in seconds.
+    auto stddev() const -> double
+    {
+        return std::sqrt(static_cast<double>(batch_size)) * timelib::stddev(samples);
+    }
+
+    /// @brief Returns the standard error of the mean time per call.
+    /// @return the standard error, in seconds.
+    auto standard_error() const -> double
+    {
+        return samples.empty() ? 0. : (timelib::stddev(samples) / std::sqrt(static_cast<double>(samples.size())));
+    }
+
+    /// @brief Returns the mean time per call, minus the overhead of the batch loop.
+    /// @param confidence the confidence level of the interval.
+    /// @return the corrected time per call, with the propagated uncertainty, in seconds.
+    auto corrected(double confidence = 0.95) const -> confidence_interval_t<double>
+    {
+        return timelib::difference_of_means(samples, baseline, confidence);
+    }
+
+    /// @brief Computes the bootstrap confidence interval of the mean time per call.
+    /// @param options the options of the bootstrap.
+    /// @return the confidence interval, in seconds.
+    auto confidence_interval(const bootstrap_options_t &options = bootstrap_options_t()) const
+        -> confidence_interval_t<double>
+    {
+        return timelib::bootstrap_mean(samples, options);
+    }
+
+    /// @brief Converts the results to a string.
+    /// @return the string representation of the results.
+    auto to_string() const -> std::string
+    {
+        std::stringstream ss;
+        ss << detail::format_time(this->mean()) << " \xC2\xB1 " << detail::format_time(this->standard_error())
+           << " per call (stddev " << detail::format_time(this->stddev()) << ", " << samples.size()
+           << " batches of " << batch_size << " calls; clock overhead " << detail::format_time(clock.overhead)
+           << ", resolution " << detail::format_time(clock.resolution) << ")";
+        if (!baseline.empty()) {
+            confidence_interval_t<double> interval = this->corrected();
+            ss << ", corrected " << detail::format_time(interval.estimate) << " \xC2\xB1 "
+               << detail::format_time(interval.half_width()) << " (overhead "
+               << detail::format_time(timelib::mean(baseline)) << ")";
+        }
+        return ss.str();
+    }
+
+    /// @brief Prints the results to an output stream.
+    /// @param lhs The output stream.
+    /// @param rhs The results to print.
+    /// @return The modified output stream.
+    friend auto operator<<(std::ostream &lhs, const batch_result_t &rhs) -> std::ostream &
+    {
+        return (lhs << rhs.to_string());
+    }
+};
+
+/// @brief Runs N batches of K calls of the function, reading the clock once per batch.
+/// @details Unlike ntimes(), which reads the clock around every call, the
+/// cost of reading the clock is spread over the K calls of a batch. When K
+/// is zero, it is chosen with choose_batch_size(). The stopwatch records a
+/// round per batch. Each batch is followed by an empty batch, which measures
+/// the overhead of the loop.
+/// @param stopwatch the stopwatch used to retrieve the elapse time.
+/// @param function the function to sample.
+/// @param batch_size the number of calls per batch, zero to choose it automatically.
+/// @return the results of the batches.
+template <std::size_t N, class Function>
+inline auto ntimes_batched(Stopwatch &stopwatch, const Function &function, std::size_t batch_size = 0)
+    -> batch_result_t
+{
+    batch_result_t result;
+    result.clock      = measure_clock();
+    result.batch_size = (batch_size > 0) ? batch_size : choose_batch_size(function, result.clock);
+    result.samples.reserve(N);
+    result.baseline.reserve(N);
+    // The empty function is called as the sampled one, see Benchmark::repeat().
+    auto empty_function = detail::empty_function_of_t<Function>::make();
+    do_not_optimize(empty_function);
+    stopwatch.reset();
+    for (std::size_t i = 0U; i < N; ++i) {
+        stopwatch.start();
+        for (std::size_t j = 0U; j < result.batch_size; ++j) {
+            detail::invoke_opaque(function);
+        }
+        result.samples.push_back(stopwatch.round().count() / static_cast<double>(result.batch_size));
+        // An empty batch, with the same loop and barriers, measures the overhead.
+        timespec_t start = timespec_t::now();
+        for (std::size_t j = 0U; j < result.batch_size; ++j) {
+            detail::invoke_opaque(empty_function);
+        }
+        result.baseline.push_back((timespec_t::now() - start).count() / static_cast<double>(result.batch_size));
+    }
+    return result;
+}
+
+} // namespace timelib
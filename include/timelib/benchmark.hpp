@@ -0,0 +1,499 @@
+/// @file benchmark.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the benchmark runner, with warmup, automatic iteration count and repetitions.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/isolation.hpp"
+#include "timelib/rusage.hpp"
+#include "timelib/statistics.hpp"
+#include "timelib/throughput.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace timelib
+{
+
+namespace detail
+{
+
+/// @brief A function doing nothing, used to measure the overhead of the benchmark loop.
+struct empty_function_t {
+    /// @brief Does nothing.
+    void operator()() const
+    {
+        // Nothing to do.
+    }
+};
+
+/// @brief Makes the empty function measured as the baseline of a benchmarked
+/// function, called the same way: directly, unless specialized.
+template <class Function>
+struct empty_function_of_t {
+    /// @brief Makes the empty function.
+    /// @return the empty function.
+    static auto make() -> empty_function_t { return empty_function_t(); }
+};
+
+/// @brief Makes the baseline of a std::function, wrapping the empty function
+/// so that the baseline includes the indirect call.
+template <>
+struct empty_function_of_t<std::function<void()>> {
+    /// @brief Makes the empty function.
+    /// @return the empty function, wrapped in a std::function.
+    static auto make() -> std::function<void()> { return std::function<void()>(empty_function_t()); }
+};
+
+} // namespace detail
+
+/// @brief The options of a benchmark run.
+struct benchmark_options_t {
+    /// @brief Constructs the default options.
+    benchmark_options_t()
+        : warmup_time(0.1)
+        , min_time(0.5)
+        , repetitions(5)
+        , max_iterations(1000000000UL)
+        , isolation()
+        , subtract_baseline(true)
+        , items_per_iteration(0)
+        , bytes_per_iteration(0)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Time spent running the function before measuring, in seconds.
+    double warmup_time;
+    /// @brief Target measurement time of each repetition, in seconds.
+    double min_time;
+    /// @brief Number of measured repetitions.
+    std::size_t repetitions;
+    /// @brief Upper bound to the number of iterations of a repetition.
+    std::size_t max_iterations;
+    /// @brief Affinity, priority and memory locking of the measuring thread.
+    isolation_options_t isolation;
+    /// @brief Measures an empty function with the same iterations, to estimate the loop overhead.
+    bool subtract_baseline;
+    /// @brief Items processed by each call of the function, zero if not relevant.
+    std::size_t items_per_iteration;
+    /// @brief Bytes processed by each call of the function, zero if not relevant.
+    std::size_t bytes_per_iteration;
+};
+
+/// @brief The measurement of a single repetition.
+struct repetition_t {
+    /// @brief Number of times the function was called.
+    std::size_t iterations;
+    /// @brief Time spent running all the iterations.
+    timespec_t elapsed;
+    /// @brief Resources used by the measuring thread while running the iterations.
+    resource_usage_t usage;
+
+    /// @brief Returns the time spent in a single iteration.
+    /// @return the time per iteration, in seconds.
+    auto time_per_iteration() const -> double
+    {
+        return (iterations > 0) ? elapsed.count() / static_cast<double>(iterations) : 0.;
+    }
+
+    /// @brief Returns the number of iterations executed per second.
+    /// @return the iterations per second.
+    auto iterations_per_second() const -> double
+    {
+        return (elapsed.count() > 0.) ? static_cast<double>(iterations) / elapsed.count() : 0.;
+    }
+};
+
+/// @brief The results of a benchmark run.
+struct benchmark_result_t {
+    /// @brief Constructs an empty result.
+    benchmark_result_t()
+        : name()
+        , repetitions()
+        , baseline()
+        , items_per_iteration(0)
+        , bytes_per_iteration(0)
+        , warnings()
+    {
+        // Nothing to do.
+    }
+
+    /// @brief The name of the benchmark.
+    std::string name;
+    /// @brief The measured repetitions.
+    std::vector<repetition_t> repetitions;
+    /// @brief The repetitions of an empty function, with the same iterations (empty if not measured).
+    std::vector<repetition_t> baseline;
+    /// @brief Items processed by each iteration, zero if not relevant.
+    std::size_t items_per_iteration;
+    /// @brief Bytes processed by each iteration, zero if not relevant.
+    std::size_t bytes_per_iteration;
+    /// @brief The warnings about the reproducibility of the run (e.g., the CPU governor).
+    std::vector<std::string> warnings;
+
+    /// @brief Returns the time per iteration of each repetition.
+    /// @return the samples, in seconds.
+    auto samples() const -> std::vector<double>
+    {
+        std::vector<double> result;
+        result.reserve(repetitions.size());
+        for (const auto &repetition : repetitions) {
+            result.push_back(repetition.time_per_iteration());
+        }
+        return result;
+    }
+
+    /// @brief Returns the mean time per iteration across repetitions.
+    /// @return the mean, in seconds.
+    auto mean() const -> double { return timelib::mean(this->samples()); }
+
+    /// @brief Returns the standard deviation of the time per iteration across repetitions.
+    /// @return the standard deviation, in seconds.
+    auto stddev() const -> double { return timelib::stddev(this->samples()); }
+
+    /// @brief Returns the fastest time per iteration across repetitions.
+    /// @return the minimum, in seconds.
+    auto min() const -> double
+    {
+        std::vector<double> values = this->samples();
+        return values.empty() ? 0. : *std::min_element(values.begin(), values.end());
+    }
+
+    /// @brief Returns the slowest time per iteration across repetitions.
+    /// @return the maximum, in seconds.
+    auto max() const -> double
+    {
+        std::vector<double> values = this->samples();
+        return values.empty() ? 0. : *std::max_element(values.begin(), values.end());
+    }
+
+    /// @brief Returns the time per iteration of each repetition of the empty function.
+    /// @return the samples of the baseline, in seconds.
+    auto baseline_samples() const -> std::vector<double>
+    {
+        std::vector<double> result;
+        result.reserve(baseline.size());
+        for (const auto &repetition : baseline) {
+            result.push_back(repetition.time_per_iteration());
+        }
+        return result;
+    }
+
+    /// @brief Returns the mean overhead of an iteration of the benchmark loop.
+    /// @return the overhead, in seconds, zero if the baseline has not been measured.
+    auto overhead() const -> double { return timelib::mean(this->baseline_samples()); }
+
+    /// @brief Returns the mean time per iteration, minus the overhead of the benchmark loop.
+    /// @details The uncertainties of the two means are propagated to the
+    /// interval (see difference_of_means()).
+    /// @param confidence the confidence level of the interval.
+    /// @return the corrected time per iteration, in seconds.
+    auto corrected(double confidence = 0.95) const -> confidence_interval_t<double>
+    {
+        return timelib::difference_of_means(this->samples(), this->baseline_samples(), confidence);
+    }
+
+    /// @brief Computes the throughput, in items or bytes per second, aggregate and per repetition.
+    /// @param unit selects either the items or the bytes per iteration.
+    /// @param options the options of the bootstrap of the mean rate.
+    /// @return the throughput.
+    auto throughput(throughput_unit_t unit, const bootstrap_options_t &options = bootstrap_options_t()) const
+        -> throughput_t
+    {
+        double per_iteration = static_cast<double>((unit == unit_bytes) ? bytes_per_iteration : items_per_iteration);
+        std::vector<double> amounts;
+        std::vector<double> seconds;
+        for (const auto &repetition : repetitions) {
+            amounts.push_back(per_iteration * static_cast<double>(repetition.iterations));
+            seconds.push_back(repetition.elapsed.count());
+        }
+        return timelib::compute_throughput(amounts, seconds, unit, options);
+    }
+
+    /// @brief Returns the number of repetitions interrupted by a context switch.
+    /// @return the number of contaminated repetitions.
+    auto contaminated() const -> std::size_t
+    {
+        std::size_t count = 0;
+        for (const auto &repetition : repetitions) {
+            count += repetition.usage.contaminated() ? 1U : 0U;
+        }
+        return count;
+    }
+
+    /// @brief Computes the statistical summary of the time per iteration across repetitions.
+    /// @param options the options of the bootstraps.
+    /// @return the summary, in seconds.
+    auto summary(const bootstrap_options_t &options = bootstrap_options_t()) const -> summary_t<double>
+    {
+        return timelib::summarize(this->samples(), options);
+    }
+
+    /// @brief Converts the results to a table, with a row for each repetition.
+    /// @return the string representation of the results.
+    auto to_string() const -> std::string
+    {
+        std::stringstream ss;
+        // The bootstrap is not free, so the rates are computed only when needed.
+        throughput_t items = (items_per_iteration > 0) ? this->throughput(unit_items) : throughput_t();
+        throughput_t bytes = (bytes_per_iteration > 0) ? this->throughput(unit_bytes) : throughput_t();
+        ss << std::left << std::setw(32) << name << std::right << std::setw(14) << "iterations" << std::setw(14)
+           << "time" << std::setw(14) << "time/iter" << std::setw(16) << "iter/s";
+        if (items_per_iteration > 0) {
+            ss << std::setw(18) << "items/s";
+        }
+        if (bytes_per_iteration > 0) {
+            ss << std::setw(14) << "bytes/s";
+        }
+        ss << std::setw(10) << "faults" << std::setw(10) << "ctx sw"
+           << "\n";
+        for (std::size_t i = 0; i < repetitions.size(); ++i) {
+            const resource_usage_t &usage = repetitions[i].usage;
+            ss << std::left << std::setw(32) << ("  #" + std::to_string(i)) << std::right << std::setw(14)
+               << repetitions[i].iterations << std::setw(14) << detail::format_time(repetitions[i].elapsed.count())
+               << std::setw(14) << detail::format_time(repetitions[i].time_per_iteration()) << std::setw(16)
+               << std::fixed << std::setprecision(1) << repetitions[i].iterations_per_second();
+            if (items_per_iteration > 0) {
+                ss << std::setw(18) << detail::format_rate(items.rates[i], unit_items);
+            }
+            if (bytes_per_iteration > 0) {
+                ss << std::setw(14) << detail::format_rate(bytes.rates[i], unit_bytes);
+            }
+            ss << std::setw(10) << (usage.minor_faults + usage.major_faults) << std::setw(10)
+               << usage.context_switches() << (usage.contaminated() ? " *" : "") << "\n";
+        }
+        ss << std::left << std::setw(32) << "  mean" << std::right << std::setw(42)
+           << detail::format_time(this->mean()) << "\n";
+        ss << std::left << std::setw(32) << "  stddev" << std::right << std::setw(42)
+           << detail::format_time(this->stddev()) << "\n";
+        ss << std::left << std::setw(32) << "  min" << std::right << std::setw(42) << detail::format_time(this->min())
+           << "\n";
+        ss << std::left << std::setw(32) << "  max" << std::right << std::setw(42) << detail::format_time(this->max())
+           << "\n";
+        if (!baseline.empty()) {
+            confidence_interval_t<double> interval = this->corrected();
+            ss << std::left << std::setw(32) << "  overhead" << std::right << std::setw(42)
+               << detail::format_time(this->overhead()) << "\n";
+            ss << std::left << std::setw(32) << "  corrected" << std::right << std::setw(42)
+               << detail::format_time(interval.estimate) << " \xC2\xB1 " << detail::format_time(interval.half_width())
+               << "\n";
+        }
+        if (items_per_iteration > 0) {
+            ss << std::left << std::setw(32) << "  items/s" << std::right << std::setw(42)
+               << detail::format_rate(items.aggregate, unit_items) << " \xC2\xB1 "
+               << detail::format_rate(items.interval.half_width(), unit_items) << "\n";
+        }
+        if (bytes_per_iteration > 0) {
+            ss << std::left << std::setw(32) << "  bytes/s" << std::right << std::setw(42)
+               << detail::format_rate(bytes.aggregate, unit_bytes) << " \xC2\xB1 "
+               << detail::format_rate(bytes.interval.half_width(), unit_bytes) << "\n";
+        }
+        if (this->contaminated() > 0) {
+            ss << "  * " << this->contaminated() << " of " << repetitions.size()
+               << " repetitions interrupted by context switches\n";
+        }
+        for (const auto &warning : warnings) {
+            ss << "  warning: " << warning << "\n";
+        }
+        return ss.str();
+    }
+
+    /// @brief Prints the results to an output stream.
+    /// @param lhs The output stream.
+    /// @param rhs The results to print.
+    /// @return The modified output stream.
+    friend auto operator<<(std::ostream &lhs, const benchmark_result_t &rhs) -> std::ostream &
+    {
+        return (lhs << rhs.to_string());
+    }
+};
+
+/// @brief A benchmark runner, which warms up, calibrates the number of
+/// iterations, and measures several repetitions of a function.
+/// @details Each repetition is a single Stopwatch round around all its
+/// iterations, so the runner does not store a sample per iteration.
+class Benchmark
+{
+public:
+    /// @brief Constructs a Benchmark.
+    /// @param name the name of the benchmark.
+    /// @param options the options of the run.
+    explicit Benchmark(std::string name, benchmark_options_t options = benchmark_options_t())
+        : _name(std::move(name))
+        , _options(options)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the name of the benchmark.
+    /// @return the name.
+    auto name() const -> const std::string & { return _name; }
+
+    /// @brief Returns the options of the benchmark.
+    /// @return a reference to the options.
+    auto options() -> benchmark_options_t & { return _options; }
+
+    /// @brief Returns the options of the benchmark.
+    /// @return a const reference to the options.
+    auto options() const -> const benchmark_options_t & { return _options; }
+
+    /// @brief Returns the stopwatch, holding a round for each measured repetition.
+    /// @return a const reference to the stopwatch.
+    auto stopwatch() const -> const Stopwatch & { return _stopwatch; }
+
+    /// @brief Runs the benchmark.
+    /// @param function the function to benchmark.
+    /// @return the results of the run.
+    template <class Function>
+    auto run(const Function &function) -> benchmark_result_t
+    {
+        benchmark_result_t result = this->make_result();
+        ScopedIsolation isolation(_options.isolation);
+        result.warnings = isolation.warnings();
+        this->warmup(function);
+        std::size_t iterations = this->calibrate(function);
+        _stopwatch.reset();
+        for (std::size_t i = 0; i < _options.repetitions; ++i) {
+            this->repeat(function, iterations, result);
+        }
+        return result;
+    }
+
+    /// @brief Creates an empty result for the benchmark.
+    /// @return the result, with the name and the amounts processed per iteration.
+    auto make_result() const -> benchmark_result_t
+    {
+        benchmark_result_t result;
+        result.name                = _name;
+        result.items_per_iteration = _options.items_per_iteration;
+        result.bytes_per_iteration = _options.bytes_per_iteration;
+        return result;
+    }
+
+    /// @brief Measures a single repetition, and its baseline if enabled, and
+    /// appends them to the result.
+    /// @param function the function to benchmark.
+    /// @param iterations the number of iterations of the repetition.
+    /// @param result the result receiving the repetition.
+    template <class Function>
+    void repeat(const Function &function, std::size_t iterations, benchmark_result_t &result)
+    {
+        resource_usage_t usage = resource_usage_t::now();
+        _stopwatch.start();
+        Benchmark::iterate(function, iterations);
+        repetition_t repetition;
+        repetition.iterations = iterations;
+        repetition.elapsed    = _stopwatch
+                                 .round(
+                                     iterations * _options.items_per_iteration,
+                                     iterations * _options.bytes_per_iteration)
+                                 .raw();
+        repetition.usage      = resource_usage_t::now() - usage;
+        result.repetitions.push_back(repetition);
+        // Measure the empty loop right after, so that both see the same machine state.
+        if (_options.subtract_baseline) {
+            // The empty function is called as the benchmarked one, and hidden
+            // from the compiler so that the call is not resolved at compile time.
+            auto empty_function = detail::empty_function_of_t<Function>::make();
+            do_not_optimize(empty_function);
+            repetition_t empty;
+            empty.iterations = iterations;
+            Benchmark::measure(empty_function, empty);
+            result.baseline.push_back(empty);
+        }
+    }
+
+    /// @brief Runs the function for the given number of iterations, and measures it.
+    /// @param function the function to benchmark.
+    /// @param iterations the number of iterations.
+    /// @return the time spent running all the iterations.
+    template <class Function>
+    static auto measure(const Function &function, std::size_t iterations) -> timespec_t
+    {
+        Stopwatch stopwatch;
+        stopwatch.start();
+        Benchmark::iterate(function, iterations);
+        return stopwatch.round().raw();
+    }
+
+    /// @brief Runs the function, in growing batches, until the warmup time has passed.
+    /// @param function the function to run.
+    template <class Function>
+    void warmup(const Function &function) const
+    {
+        double elapsed         = 0.;
+        std::size_t iterations = 1;
+        while (elapsed < _options.warmup_time) {
+            elapsed += Benchmark::measure(function, iterations).count();
+            iterations = std::min(iterations * 2, _options.max_iterations);
+        }
+    }
+
+    /// @brief Finds the number of iterations needed to reach the target measurement time.
+    /// @param function the function to run.
+    /// @return the number of iterations of each repetition.
+    template <class Function>
+    auto calibrate(const Function &function) const -> std::size_t
+    {
+        std::size_t iterations = 1;
+        while (iterations < _options.max_iterations) {
+            double elapsed = Benchmark::measure(function, iterations).count();
+            if (elapsed >= _options.min_time) {
+                break;
+            }
+            // Aim slightly above the target, but grow at most tenfold when the
+            // measurement is too short to be trusted.
+            double multiplier = 10.;
+            if (elapsed > (_options.min_time / 10.)) {
+                multiplier = std::max(1.4 * _options.min_time / elapsed, 1.1);
+            }
+            double next = std::ceil(static_cast<double>(iterations) * multiplier);
+            iterations  = std::min(static_cast<std::size_t>(next), _options.max_iterations);
+        }
+        return std::max<std::size_t>(iterations, 1);
+    }
+
+    /// @brief Runs the function for the iterations of the repetition, and
+    /// measures both the elapsed time and the resources used.
+    /// @param function the function to benchmark.
+    /// @param repetition the repetition, whose iterations must be set.
+    template <class Function>
+    static void measure(const Function &function, repetition_t &repetition)
+    {
+        resource_usage_t usage = resource_usage_t::now();
+        repetition.elapsed     = Benchmark::measure(function, repetition.iterations);
+        repetition.usage       = resource_usage_t::now() - usage;
+    }
+
+private:
+    /// @brief Runs the function for the given number of iterations, keeping its results alive.
+    /// @param function the function to run.
+    /// @param iterations the number of iterations.
+    template <class Function>
+    static void iterate(const Function &function, std::size_t iterations)
+    {
+        for (std::size_t i = 0; i < iterations; ++i) {
+            detail::invoke_opaque(function);
+        }
+    }
+
+    /// @brief The name of the benchmark.
+    std::string _name;
+    /// @brief The options of the run.
+    benchmark_options_t _options;
+    /// @brief The stopwatch used to measure the repetitions.
+    Stopwatch _stopwatch;
+};
+
+} // namespace timelib
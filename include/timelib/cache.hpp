@@ -0,0 +1,288 @@
+/// @file cache.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the cold-cache and warm-cache measurement of a function.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/compare.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define TIMELIB_HAS_CLFLUSH 1
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace timelib
+{
+
+namespace detail
+{
+
+/// @brief The size of a cache line, assumed by the eviction.
+constexpr std::size_t cache_line_size = 64;
+
+/// @brief Parses a cache size as written by sysfs (e.g., "32K", "8192K", "32M").
+/// @param text the size.
+/// @return the size in bytes, zero if it cannot be parsed.
+inline auto parse_cache_size(const std::string &text) -> std::size_t
+{
+    char *end = nullptr;
+    auto size = static_cast<std::size_t>(std::strtoul(text.c_str(), &end, 10));
+    if ((end != nullptr) && ((*end == 'K') || (*end == 'k'))) {
+        size *= 1024;
+    } else if ((end != nullptr) && ((*end == 'M') || (*end == 'm'))) {
+        size *= 1024 * 1024;
+    }
+    return size;
+}
+
+/// @brief Prints a row of the warm and cold table.
+/// @param ss the stream.
+/// @param label the label of the row.
+/// @param warm the warm time, in seconds.
+/// @param cold the cold time, in seconds.
+inline void cache_row(std::stringstream &ss, const std::string &label, double warm, double cold)
+{
+    ss << std::left << std::setw(32) << label << std::right << std::setw(14) << detail::format_time(warm)
+       << std::setw(14) << detail::format_time(cold) << std::setw(14) << std::fixed << std::setprecision(2)
+       << ((warm > 0.) ? (cold / warm) : 0.) << "\n";
+}
+
+} // namespace detail
+
+/// @brief Returns the size of the largest cache of the first processor.
+/// @details Reads sysfs on Linux, then falls back to sysconf, and finally
+/// to 32 MiB, which exceeds the last level cache of most desktop processors.
+/// @return the size, in bytes.
+inline auto last_level_cache_size() -> std::size_t
+{
+    std::size_t size = 0;
+    for (int index = 0; index < 8; ++index) {
+        std::ifstream file("/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/size");
+        std::string text;
+        if (file >> text) {
+            size = std::max(size, detail::parse_cache_size(text));
+        }
+    }
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+    if (size == 0) {
+        long value = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        size       = (value > 0) ? static_cast<std::size_t>(value) : 0;
+    }
+#endif
+    return (size > 0) ? size : (32UL * 1024UL * 1024UL);
+}
+
+/// @brief How the caches are emptied before a cold measurement.
+enum eviction_t : unsigned char {
+    eviction_buffer, ///< Writes a buffer larger than the last level cache, which evicts everything else.
+    eviction_flush   ///< Flushes the lines of a known working set (clflush), falls back to the buffer elsewhere.
+};
+
+/// @brief Evicts data from the processor caches.
+class CacheEvictor
+{
+public:
+    /// @brief Constructs a CacheEvictor.
+    /// @param buffer_size the size of the eviction buffer, zero for twice the last level cache.
+    explicit CacheEvictor(std::size_t buffer_size = 0)
+        : _buffer((buffer_size > 0) ? buffer_size : (2 * timelib::last_level_cache_size()), 0)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the size of the eviction buffer.
+    /// @return the size, in bytes.
+    auto size() const -> std::size_t { return _buffer.size(); }
+
+    /// @brief Writes a byte in each line of the buffer, which replaces the
+    /// content of all the cache levels, and the dirty lines of the buffer
+    /// also push out the modified lines of the working set.
+    void evict()
+    {
+        for (std::size_t i = 0; i < _buffer.size(); i += detail::cache_line_size) {
+            ++_buffer[i];
+        }
+        char *data = _buffer.data();
+        timelib::do_not_optimize(data);
+    }
+
+    /// @brief Flushes the cache lines holding the given memory.
+    /// @details Much cheaper than evict(), but it only removes the given
+    /// memory; where clflush is not available, it falls back to evict().
+    /// @param data the beginning of the memory.
+    /// @param size the size of the memory, in bytes.
+    void flush(const void *data, std::size_t size)
+    {
+#if defined(TIMELIB_HAS_CLFLUSH)
+        const char *begin = static_cast<const char *>(data);
+        for (std::size_t i = 0; i < size; i += detail::cache_line_size) {
+            _mm_clflush(begin + i);
+        }
+        if (size > 0) {
+            _mm_clflush(begin + size - 1);
+        }
+        _mm_mfence();
+#else
+        (void)data;
+        (void)size;
+        this->evict();
+#endif
+    }
+
+private:
+    /// @brief The eviction buffer.
+    std::vector<char> _buffer;
+};
+
+/// @brief The options of a cold-cache and warm-cache measurement.
+struct cache_options_t {
+    /// @brief Constructs the default options.
+    cache_options_t()
+        : benchmark()
+        , samples(50)
+        , eviction(eviction_buffer)
+        , buffer_size(0)
+        , working_set(nullptr)
+        , working_set_size(0)
+        , bootstrap()
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Warmup time, isolation and baseline subtraction of the measurement.
+    benchmark_options_t benchmark;
+    /// @brief The number of calls measured in each mode, each one timed on its own.
+    std::size_t samples;
+    /// @brief How the caches are emptied before a cold call.
+    eviction_t eviction;
+    /// @brief The size of the eviction buffer, zero for twice the last level cache.
+    std::size_t buffer_size;
+    /// @brief The memory flushed by eviction_flush.
+    const void *working_set;
+    /// @brief The size of the memory flushed by eviction_flush, in bytes.
+    std::size_t working_set_size;
+    /// @brief Options of the bootstrap of the slowdown interval.
+    bootstrap_options_t bootstrap;
+};
+
+/// @brief The results of a cold-cache and warm-cache measurement.
+struct cache_result_t {
+    /// @brief The name of the benchmark.
+    std::string name;
+    /// @brief The calls made right after another call, with the caches warm.
+    benchmark_result_t warm;
+    /// @brief The calls made right after the eviction, with the caches cold.
+    benchmark_result_t cold;
+    /// @brief Ratio between the median cold and warm times (greater than one when the caches matter).
+    confidence_interval_t<double> slowdown;
+
+    /// @brief Converts the results to a table, with the warm and cold results side by side.
+    /// @return the string representation of the results.
+    auto to_string() const -> std::string
+    {
+        std::stringstream ss;
+        ss << std::left << std::setw(32) << name << std::right << std::setw(14) << "warm" << std::setw(14) << "cold"
+           << std::setw(14) << "cold/warm"
+           << "\n";
+        std::vector<double> warm_samples = warm.samples();
+        std::vector<double> cold_samples = cold.samples();
+        detail::cache_row(ss, "  median", timelib::median(warm_samples), timelib::median(cold_samples));
+        detail::cache_row(ss, "  mean", warm.mean(), cold.mean());
+        detail::cache_row(ss, "  min", warm.min(), cold.min());
+        detail::cache_row(ss, "  max", warm.max(), cold.max());
+        if (!warm.baseline.empty() && !cold.baseline.empty()) {
+            detail::cache_row(ss, "  corrected", warm.corrected().estimate, cold.corrected().estimate);
+        }
+        ss << std::left << std::setw(32) << "  slowdown" << std::right << std::setw(42) << std::fixed
+           << std::setprecision(2) << slowdown.estimate << " [" << slowdown.lower << ", " << slowdown.upper << "] @ "
+           << std::setprecision(0) << (slowdown.confidence * 100.) << "%\n";
+        return ss.str();
+    }
+
+    /// @brief Prints the results to an output stream.
+    /// @param lhs The output stream.
+    /// @param rhs The results to print.
+    /// @return The modified output stream.
+    friend auto operator<<(std::ostream &lhs, const cache_result_t &rhs) -> std::ostream &
+    {
+        return (lhs << rhs.to_string());
+    }
+};
+
+/// @brief Measures the function with warm and with cold caches.
+/// @details Each call is timed on its own, so that the caches can be
+/// emptied before it without timing the eviction. A warm call follows an
+/// untimed call of the function, a cold call follows the eviction; the two
+/// modes alternate, so that both see the same state of the machine. When the
+/// baseline is enabled, an empty call after each warm-up or eviction
+/// measures the cost of reading the clock in the same conditions.
+/// @param name the name of the benchmark.
+/// @param function the function to measure.
+/// @param options the options of the measurement.
+/// @return the warm and cold results.
+/// @throw std::invalid_argument if eviction_flush is requested without a working set.
+template <class Function>
+inline auto measure_cache(
+    const std::string &name,
+    const Function &function,
+    const cache_options_t &options = cache_options_t()) -> cache_result_t
+{
+    if ((options.eviction == eviction_flush) && ((options.working_set == nullptr) || (options.working_set_size == 0))) {
+        throw std::invalid_argument("Flushing the caches needs the working set of the function.");
+    }
+    cache_result_t result;
+    result.name      = name;
+    result.warm.name = name + "/warm";
+    result.cold.name = name + "/cold";
+    ScopedIsolation isolation(options.benchmark.isolation);
+    result.warm.warnings = isolation.warnings();
+    result.cold.warnings = isolation.warnings();
+    CacheEvictor evictor(options.buffer_size);
+    auto evict = [&]() {
+        if (options.eviction == eviction_flush) {
+            evictor.flush(options.working_set, options.working_set_size);
+        } else {
+            evictor.evict();
+        }
+    };
+    Benchmark(name, options.benchmark).warmup(function);
+    for (std::size_t i = 0; i < options.samples; ++i) {
+        repetition_t repetition;
+        repetition.iterations = 1;
+        detail::invoke_opaque(function);
+        Benchmark::measure(function, repetition);
+        result.warm.repetitions.push_back(repetition);
+        evict();
+        Benchmark::measure(function, repetition);
+        result.cold.repetitions.push_back(repetition);
+        if (options.benchmark.subtract_baseline) {
+            detail::invoke_opaque(function);
+            Benchmark::measure(detail::empty_function_t(), repetition);
+            result.warm.baseline.push_back(repetition);
+            evict();
+            Benchmark::measure(detail::empty_function_t(), repetition);
+            result.cold.baseline.push_back(repetition);
+        }
+    }
+    result.slowdown = detail::bootstrap_ratio(result.cold.samples(), result.warm.samples(), options.bootstrap);
+    return result;
+}
+
+} // namespace timelib
@@ -0,0 +1,245 @@
+/// @file compare.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the A/B comparison of two implementations, with significance testing.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/benchmark.hpp"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace timelib
+{
+
+namespace detail
+{
+
+/// @brief Formats a p-value with three significant decimals.
+/// @param p_value the p-value.
+/// @return the formatted p-value.
+inline auto format_p(double p_value) -> std::string
+{
+    char buffer[32];
+    (void)std::snprintf(buffer, sizeof(buffer), "%.3f", p_value);
+    return std::string(buffer);
+}
+
+/// @brief Bootstraps the ratio between the medians of two independent sets of samples.
+/// @param a the samples of the numerator.
+/// @param b the samples of the denominator.
+/// @param options the bootstrap options.
+/// @return the confidence interval of the ratio.
+inline auto bootstrap_ratio(
+    const std::vector<double> &a,
+    const std::vector<double> &b,
+    const bootstrap_options_t &options) -> confidence_interval_t<double>
+{
+    confidence_interval_t<double> interval;
+    interval.confidence = options.confidence;
+    interval.estimate   = timelib::median(a) / timelib::median(b);
+    interval.lower = interval.upper = interval.estimate;
+    if ((a.size() < 2) || (b.size() < 2) || (options.resamples == 0)) {
+        return interval;
+    }
+    std::mt19937_64 engine(options.seed);
+    std::uniform_int_distribution<std::size_t> pick_a(0, a.size() - 1);
+    std::uniform_int_distribution<std::size_t> pick_b(0, b.size() - 1);
+    std::vector<double> resample_a(a.size());
+    std::vector<double> resample_b(b.size());
+    std::vector<double> ratios(options.resamples);
+    for (auto &ratio : ratios) {
+        for (auto &value : resample_a) {
+            value = a[pick_a(engine)];
+        }
+        for (auto &value : resample_b) {
+            value = b[pick_b(engine)];
+        }
+        ratio = timelib::median(resample_a) / timelib::median(resample_b);
+    }
+    std::sort(ratios.begin(), ratios.end());
+    double alpha   = (1. - options.confidence) / 2.;
+    interval.lower = timelib::percentile_sorted(ratios, 100. * alpha);
+    interval.upper = timelib::percentile_sorted(ratios, 100. * (1. - alpha));
+    return interval;
+}
+
+/// @brief Returns the samples of a benchmark, minus the overhead of its loop.
+/// @param result the results of the benchmark.
+/// @return the samples, in seconds per iteration, unchanged if the baseline has not been measured.
+inline auto corrected_samples(const benchmark_result_t &result) -> std::vector<double>
+{
+    std::vector<double> samples = result.samples();
+    double overhead             = result.overhead();
+    for (auto &sample : samples) {
+        sample -= overhead;
+    }
+    return samples;
+}
+
+} // namespace detail
+
+/// @brief The hypothesis test used to compare two benchmarks.
+enum test_t : unsigned char {
+    mann_whitney, ///< Mann-Whitney U test, robust to outliers and skewed distributions.
+    welch         ///< Welch t-test, compares the means without assuming equal variances.
+};
+
+/// @brief The options of an A/B comparison.
+struct comparison_options_t {
+    /// @brief Constructs the default options.
+    comparison_options_t()
+        : benchmark()
+        , bootstrap()
+        , test(mann_whitney)
+        , alpha(0.05)
+    {
+        benchmark.min_time    = 0.05;
+        benchmark.repetitions = 20;
+    }
+
+    /// @brief Warmup, target time and number of repetitions of each side.
+    benchmark_options_t benchmark;
+    /// @brief Options of the bootstrap of the speedup interval.
+    bootstrap_options_t bootstrap;
+    /// @brief The hypothesis test.
+    test_t test;
+    /// @brief The significance level.
+    double alpha;
+};
+
+/// @brief The results of an A/B comparison.
+struct comparison_t {
+    /// @brief The results of the first implementation (the reference).
+    benchmark_result_t a;
+    /// @brief The results of the second implementation (the candidate).
+    benchmark_result_t b;
+    /// @brief Ratio between the median times of A and B (greater than one when B is faster).
+    confidence_interval_t<double> speedup;
+    /// @brief Relative time saved by B with respect to A, in percent (positive when B is faster).
+    confidence_interval_t<double> improvement;
+    /// @brief The test used, and its result.
+    test_t test;
+    /// @brief The result of the hypothesis test.
+    test_result_t result;
+    /// @brief The significance level.
+    double alpha;
+    /// @brief The warnings about the reproducibility of the comparison (e.g., the CPU governor).
+    std::vector<std::string> warnings;
+
+    /// @brief Checks if the difference between A and B is statistically significant.
+    /// @return true if the p-value is below the significance level.
+    auto significant() const -> bool { return result.p_value < alpha; }
+
+    /// @brief Returns a one-line verdict (e.g., "B is 12.3% ± 1.1% faster than A, p<0.001").
+    /// @return the verdict.
+    auto verdict() const -> std::string
+    {
+        char buffer[256];
+        double change = improvement.estimate;
+        std::string p = (result.p_value < 0.001) ? std::string("p<0.001") : ("p=" + detail::format_p(result.p_value));
+        (void)std::snprintf(
+            buffer, sizeof(buffer), "%s is %.1f%% \xC2\xB1 %.1f%% %s than %s, %s", b.name.c_str(),
+            (change < 0.) ? -change : change, improvement.half_width(), (change < 0.) ? "slower" : "faster",
+            a.name.c_str(), p.c_str());
+        if (!this->significant()) {
+            return "No significant difference (" + std::string(buffer) + ")";
+        }
+        return std::string(buffer);
+    }
+
+    /// @brief Converts the comparison to a string, with both results and the verdict.
+    /// @return the string representation of the comparison.
+    auto to_string() const -> std::string
+    {
+        std::stringstream ss;
+        ss << a << "\n" << b << "\n";
+        ss << "speedup  : " << std::fixed << std::setprecision(3) << speedup.estimate << "x [" << speedup.lower
+           << ", " << speedup.upper << "] @ " << std::setprecision(0) << (speedup.confidence * 100.) << "%\n";
+        ss << "test     : " << ((test == welch) ? "Welch t-test" : "Mann-Whitney U") << ", statistic "
+           << std::setprecision(3) << result.statistic << "\n";
+        ss << "verdict  : " << this->verdict() << "\n";
+        for (const auto &warning : warnings) {
+            ss << "warning  : " << warning << "\n";
+        }
+        return ss.str();
+    }
+
+    /// @brief Prints the comparison to an output stream.
+    /// @param lhs The output stream.
+    /// @param rhs The comparison to print.
+    /// @return The modified output stream.
+    friend auto operator<<(std::ostream &lhs, const comparison_t &rhs) -> std::ostream &
+    {
+        return (lhs << rhs.to_string());
+    }
+};
+
+/// @brief Compares two implementations, interleaving their repetitions.
+/// @details Both functions are warmed up and calibrated separately, then
+/// their repetitions alternate (A B, B A, A B, ...), so that drifts in the
+/// machine state affect both sides equally. The isolation and the baseline
+/// of options.benchmark are applied as by Benchmark::run(): the loop
+/// overhead of each side is removed from its samples before the speedup and
+/// the test are computed.
+/// @param name_a the name of the first implementation (the reference).
+/// @param function_a the first implementation.
+/// @param name_b the name of the second implementation (the candidate).
+/// @param function_b the second implementation.
+/// @param options the options of the comparison.
+/// @return the results of the comparison.
+template <class FunctionA, class FunctionB>
+inline auto compare(
+    const std::string &name_a,
+    const FunctionA &function_a,
+    const std::string &name_b,
+    const FunctionB &function_b,
+    const comparison_options_t &options = comparison_options_t()) -> comparison_t
+{
+    comparison_t comparison;
+    ScopedIsolation isolation(options.benchmark.isolation);
+    comparison.warnings = isolation.warnings();
+    Benchmark benchmark_a(name_a, options.benchmark);
+    Benchmark benchmark_b(name_b, options.benchmark);
+    benchmark_a.warmup(function_a);
+    benchmark_b.warmup(function_b);
+    std::size_t iterations_a = benchmark_a.calibrate(function_a);
+    std::size_t iterations_b = benchmark_b.calibrate(function_b);
+
+    comparison.a = benchmark_a.make_result();
+    comparison.b = benchmark_b.make_result();
+    for (std::size_t i = 0; i < options.benchmark.repetitions; ++i) {
+        if ((i % 2) == 0) {
+            benchmark_a.repeat(function_a, iterations_a, comparison.a);
+            benchmark_b.repeat(function_b, iterations_b, comparison.b);
+        } else {
+            benchmark_b.repeat(function_b, iterations_b, comparison.b);
+            benchmark_a.repeat(function_a, iterations_a, comparison.a);
+        }
+    }
+
+    std::vector<double> samples_a = detail::corrected_samples(comparison.a);
+    std::vector<double> samples_b = detail::corrected_samples(comparison.b);
+    comparison.speedup            = detail::bootstrap_ratio(samples_a, samples_b, options.bootstrap);
+    // Time saved by B, in percent: 100 * (1 - 1 / speedup).
+    comparison.improvement.confidence = comparison.speedup.confidence;
+    comparison.improvement.estimate   = 100. * (1. - (1. / comparison.speedup.estimate));
+    comparison.improvement.lower      = 100. * (1. - (1. / comparison.speedup.lower));
+    comparison.improvement.upper      = 100. * (1. - (1. / comparison.speedup.upper));
+    comparison.test                   = options.test;
+    comparison.alpha                  = options.alpha;
+    if (options.test == welch) {
+        comparison.result = timelib::welch_t_test(samples_a, samples_b);
+    } else {
+        comparison.result = timelib::mann_whitney_u(samples_a, samples_b);
+    }
+    return comparison;
+}
+
+} // namespace timelib
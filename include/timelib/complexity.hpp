@@ -0,0 +1,349 @@
+/// @file complexity.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines parameterized benchmarks, and the fitting of their results to complexity classes.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace timelib
+{
+
+/// @brief Generates the arguments first, first + step, ..., up to last (included).
+/// @param first the first argument.
+/// @param last the upper bound of the arguments.
+/// @param step the distance between two arguments.
+/// @return the arguments.
+/// @throw std::invalid_argument if the step is zero.
+inline auto linear_range(std::size_t first, std::size_t last, std::size_t step = 1) -> std::vector<std::size_t>
+{
+    if (step == 0) {
+        throw std::invalid_argument("The step of a linear range must be positive.");
+    }
+    std::vector<std::size_t> arguments;
+    for (std::size_t argument = first; argument <= last; argument += step) {
+        arguments.push_back(argument);
+        if ((last - argument) < step) {
+            break;
+        }
+    }
+    return arguments;
+}
+
+/// @brief Generates the arguments first, first * multiplier, ..., up to last (always included).
+/// @param first the first argument.
+/// @param last the last argument.
+/// @param multiplier the ratio between two arguments.
+/// @return the arguments.
+/// @throw std::invalid_argument if the first argument is zero, or the multiplier is lower than two.
+inline auto geometric_range(std::size_t first, std::size_t last, std::size_t multiplier = 2) -> std::vector<std::size_t>
+{
+    if ((first == 0) || (multiplier < 2)) {
+        throw std::invalid_argument("A geometric range needs a positive start, and a multiplier of at least two.");
+    }
+    std::vector<std::size_t> arguments;
+    for (std::size_t argument = first; argument < last; argument *= multiplier) {
+        arguments.push_back(argument);
+        if (argument > (last / multiplier)) {
+            break;
+        }
+    }
+    if (first <= last) {
+        arguments.push_back(last);
+    }
+    return arguments;
+}
+
+/// @brief The asymptotic complexity classes used to fit the results.
+enum complexity_t : unsigned char {
+    o_1,         ///< Constant time.
+    o_log_n,     ///< Logarithmic time.
+    o_n,         ///< Linear time.
+    o_n_log_n,   ///< Linearithmic time.
+    o_n_squared, ///< Quadratic time.
+    o_n_cubed    ///< Cubic time.
+};
+
+/// @brief Returns the conventional notation of a complexity class (e.g., "O(n log n)").
+/// @param complexity the complexity class.
+/// @return the notation.
+inline auto to_string(complexity_t complexity) -> std::string
+{
+    static const char *names[] = {"O(1)", "O(log n)", "O(n)", "O(n log n)", "O(n^2)", "O(n^3)"};
+    return names[complexity];
+}
+
+/// @brief Evaluates the growth function of a complexity class.
+/// @param complexity the complexity class.
+/// @param n the size of the input.
+/// @return the value of the growth function.
+inline auto complexity_function(complexity_t complexity, double n) -> double
+{
+    switch (complexity) {
+    case o_log_n:
+        return std::log2(n);
+    case o_n:
+        return n;
+    case o_n_log_n:
+        return n * std::log2(n);
+    case o_n_squared:
+        return n * n;
+    case o_n_cubed:
+        return n * n * n;
+    default:
+        return 1.;
+    }
+}
+
+/// @brief The fit of a set of measurements to a complexity class.
+struct complexity_fit_t {
+    /// @brief The complexity class.
+    complexity_t complexity;
+    /// @brief The coefficient of the growth function, in seconds (time ~ coefficient * f(n)).
+    double coefficient;
+    /// @brief The root mean square of the residuals, relative to the mean time.
+    double rms;
+    /// @brief The residual of each measurement (measured minus predicted time), in seconds.
+    std::vector<double> residuals;
+
+    /// @brief Predicts the time for an input of the given size.
+    /// @param n the size of the input.
+    /// @return the predicted time, in seconds.
+    auto predict(double n) const -> double { return coefficient * complexity_function(complexity, n); }
+
+    /// @brief Converts the fit to a string (e.g., "O(n log n), 1.20 ns * f(n), rms 3.1%").
+    /// @return the string representation of the fit.
+    auto to_string() const -> std::string
+    {
+        std::stringstream ss;
+        ss << timelib::to_string(complexity) << ", ";
+        // Steep growth functions have coefficients far below a nanosecond.
+        if ((coefficient < 1e-11) && (coefficient > -1e-11)) {
+            ss << std::scientific << std::setprecision(2) << coefficient << " s";
+        } else {
+            ss << detail::format_time(coefficient);
+        }
+        ss << " * f(n), rms " << std::fixed << std::setprecision(1) << (rms * 100.) << "%";
+        return ss.str();
+    }
+};
+
+/// @brief Fits the measurements to a complexity class, with a least-squares
+/// fit of a single coefficient (time ~ coefficient * f(n)).
+/// @param arguments the sizes of the inputs.
+/// @param times the time measured for each input, in seconds.
+/// @param complexity the complexity class.
+/// @return the fit.
+/// @throw std::invalid_argument if the vectors have different sizes, or are
+/// empty, or an argument is zero (log(0) is not defined).
+inline auto fit_complexity(
+    const std::vector<std::size_t> &arguments,
+    const std::vector<double> &times,
+    complexity_t complexity) -> complexity_fit_t
+{
+    if ((arguments.size() != times.size()) || arguments.empty()) {
+        throw std::invalid_argument("The fit needs a time for each argument.");
+    }
+    if (std::find(arguments.begin(), arguments.end(), 0U) != arguments.end()) {
+        throw std::invalid_argument("The fit needs arguments of at least one.");
+    }
+    double sum_ft = 0.;
+    double sum_ff = 0.;
+    double sum_t  = 0.;
+    for (std::size_t i = 0; i < arguments.size(); ++i) {
+        double f = complexity_function(complexity, static_cast<double>(arguments[i]));
+        sum_ft += f * times[i];
+        sum_ff += f * f;
+        sum_t += times[i];
+    }
+    complexity_fit_t fit;
+    fit.complexity  = complexity;
+    fit.coefficient = (sum_ff > 0.) ? (sum_ft / sum_ff) : 0.;
+    double sum_rr   = 0.;
+    for (std::size_t i = 0; i < arguments.size(); ++i) {
+        double residual = times[i] - fit.predict(static_cast<double>(arguments[i]));
+        fit.residuals.push_back(residual);
+        sum_rr += residual * residual;
+    }
+    double mean = sum_t / static_cast<double>(times.size());
+    fit.rms     = (mean > 0.) ? (std::sqrt(sum_rr / static_cast<double>(times.size())) / mean) : 0.;
+    return fit;
+}
+
+/// @brief Fits the measurements to every complexity class.
+/// @param arguments the sizes of the inputs.
+/// @param times the time measured for each input, in seconds.
+/// @return the fits, sorted from the best (lowest rms) to the worst.
+/// @throw std::invalid_argument if the fit is not possible, see fit_complexity().
+inline auto fit_complexities(const std::vector<std::size_t> &arguments, const std::vector<double> &times)
+    -> std::vector<complexity_fit_t>
+{
+    std::vector<complexity_fit_t> fits;
+    for (unsigned char c = o_1; c <= o_n_cubed; ++c) {
+        fits.push_back(fit_complexity(arguments, times, static_cast<complexity_t>(c)));
+    }
+    // A NaN rms (e.g., from overflowing times) sorts last, keeping the order strict and weak.
+    std::stable_sort(fits.begin(), fits.end(), [](const complexity_fit_t &lhs, const complexity_fit_t &rhs) {
+        if (std::isnan(lhs.rms) || std::isnan(rhs.rms)) {
+            return !std::isnan(lhs.rms) && std::isnan(rhs.rms);
+        }
+        return lhs.rms < rhs.rms;
+    });
+    return fits;
+}
+
+/// @brief The results of a parameterized benchmark.
+struct parameterized_result_t {
+    /// @brief The name of the benchmark.
+    std::string name;
+    /// @brief The arguments, i.e., the sizes of the inputs.
+    std::vector<std::size_t> arguments;
+    /// @brief The results of the benchmark for each argument.
+    std::vector<benchmark_result_t> results;
+    /// @brief The fits to every complexity class, from the best to the worst.
+    std::vector<complexity_fit_t> fits;
+
+    /// @brief Returns the median time per iteration for each argument.
+    /// @return the times, in seconds.
+    auto times() const -> std::vector<double>
+    {
+        std::vector<double> values;
+        for (const auto &result : results) {
+            values.push_back(result.repetitions.empty() ? 0. : timelib::median(result.samples()));
+        }
+        return values;
+    }
+
+    /// @brief Returns the complexity class that best fits the results.
+    /// @return the best fit.
+    /// @throw std::runtime_error if the results have not been fitted.
+    auto best_fit() const -> const complexity_fit_t &
+    {
+        if (fits.empty()) {
+            throw std::runtime_error("The results of '" + name + "' have not been fitted.");
+        }
+        return fits.front();
+    }
+
+    /// @brief Converts the results to a table, with the time, prediction and
+    /// residual of each argument, followed by the fits.
+    /// @return the string representation of the results.
+    auto to_string() const -> std::string
+    {
+        std::stringstream ss;
+        std::vector<double> values = this->times();
+        ss << std::left << std::setw(32) << name << std::right << std::setw(14) << "time/iter" << std::setw(14)
+           << "predicted" << std::setw(14) << "residual"
+           << "\n";
+        for (std::size_t i = 0; i < arguments.size(); ++i) {
+            ss << std::left << std::setw(32) << ("  n=" + std::to_string(arguments[i])) << std::right << std::setw(14)
+               << detail::format_time(values[i]);
+            if (!fits.empty()) {
+                ss << std::setw(14) << detail::format_time(fits.front().predict(static_cast<double>(arguments[i])))
+                   << std::setw(14) << detail::format_time(fits.front().residuals[i]);
+            }
+            ss << "\n";
+        }
+        for (std::size_t i = 0; i < fits.size(); ++i) {
+            ss << std::left << std::setw(32) << ((i == 0) ? "  best fit" : "") << fits[i].to_string() << "\n";
+        }
+        return ss.str();
+    }
+
+    /// @brief Prints the results to an output stream.
+    /// @param lhs The output stream.
+    /// @param rhs The results to print.
+    /// @return The modified output stream.
+    friend auto operator<<(std::ostream &lhs, const parameterized_result_t &rhs) -> std::ostream &
+    {
+        return (lhs << rhs.to_string());
+    }
+};
+
+/// @brief A benchmark run over a range of arguments (i.e., sizes of the
+/// input), whose results are fitted to the common complexity classes.
+class ParameterizedBenchmark
+{
+public:
+    /// @brief Constructs a ParameterizedBenchmark.
+    /// @param name the name of the benchmark.
+    /// @param arguments the arguments, e.g., from linear_range() or geometric_range().
+    /// @param options the options of the run of each argument.
+    /// @throw std::invalid_argument if an argument is zero, which cannot be fitted.
+    ParameterizedBenchmark(
+        std::string name,
+        std::vector<std::size_t> arguments,
+        benchmark_options_t options = benchmark_options_t())
+        : _name(std::move(name))
+        , _arguments(std::move(arguments))
+        , _options(options)
+    {
+        if (std::find(_arguments.begin(), _arguments.end(), 0U) != _arguments.end()) {
+            throw std::invalid_argument("The arguments of a parameterized benchmark must be at least one.");
+        }
+    }
+
+    /// @brief Returns the name of the benchmark.
+    /// @return the name.
+    auto name() const -> const std::string & { return _name; }
+
+    /// @brief Returns the arguments of the benchmark.
+    /// @return a const reference to the arguments.
+    auto arguments() const -> const std::vector<std::size_t> & { return _arguments; }
+
+    /// @brief Returns the options of the benchmark.
+    /// @return a reference to the options.
+    auto options() -> benchmark_options_t & { return _options; }
+
+    /// @brief Runs the benchmark for each argument, and fits the results.
+    /// @details The factory is called once per argument, outside of the
+    /// measurements, and returns the function to benchmark. This way, the
+    /// input of size n can be prepared without being measured:
+    /// @code
+    /// bench.run([](std::size_t n) {
+    ///     std::vector<int> data(n);
+    ///     return [data]() { return std::accumulate(data.begin(), data.end(), 0); };
+    /// });
+    /// @endcode
+    /// @param factory a function taking the argument, and returning the function to benchmark.
+    /// @return the results of the run.
+    template <class Factory>
+    auto run(const Factory &factory) -> parameterized_result_t
+    {
+        parameterized_result_t result;
+        result.name      = _name;
+        result.arguments = _arguments;
+        for (std::size_t argument : _arguments) {
+            auto function = factory(argument);
+            Benchmark benchmark(_name + "/" + std::to_string(argument), _options);
+            result.results.push_back(benchmark.run(function));
+        }
+        if (!_arguments.empty()) {
+            result.fits = fit_complexities(result.arguments, result.times());
+        }
+        return result;
+    }
+
+private:
+    /// @brief The name of the benchmark.
+    std::string _name;
+    /// @brief The arguments of the benchmark.
+    std::vector<std::size_t> _arguments;
+    /// @brief The options of the run of each argument.
+    benchmark_options_t _options;
+};
+
+} // namespace timelib
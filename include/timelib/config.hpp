@@ -0,0 +1,45 @@
+/// @file config.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the helper macros of the library, and selects between the header-only library and the compiled one.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+/// @brief Concatenates two tokens, after expanding them.
+#define TIMELIB_CONCAT_IMPL(lhs, rhs) lhs##rhs
+/// @brief Concatenates two tokens, after expanding them.
+#define TIMELIB_CONCAT(lhs, rhs) TIMELIB_CONCAT_IMPL(lhs, rhs)
+
+// The heavy subsystems (JSON, reports, history, the statistics) are
+// declared in their header and defined in a matching header under
+// timelib/detail. By default the definitions are included inline, and the
+// library is header-only. When TIMELIB_COMPILED_LIB is defined (by linking
+// the timelib::compiled target), the headers keep only the declarations,
+// and the definitions come from the compiled library.
+
+#if defined(TIMELIB_COMPILED_LIB) && defined(TIMELIB_SHARED_LIB) && defined(_WIN32)
+#if defined(TIMELIB_EXPORTS)
+/// @brief Exports a symbol from the shared library.
+#define TIMELIB_API __declspec(dllexport)
+#else
+/// @brief Imports a symbol from the shared library.
+#define TIMELIB_API __declspec(dllimport)
+#endif
+#elif defined(TIMELIB_COMPILED_LIB) && defined(TIMELIB_SHARED_LIB)
+/// @brief Exports a symbol from the shared library.
+#define TIMELIB_API __attribute__((visibility("default")))
+#else
+/// @brief Nothing to export, the library is header-only or static.
+#define TIMELIB_API
+#endif
+
+#if defined(TIMELIB_COMPILED_LIB)
+/// @brief The definitions of the heavy subsystems are compiled once, in the library.
+#define TIMELIB_INLINE TIMELIB_API
+#else
+/// @brief The definitions of the heavy subsystems are inline, in every translation unit.
+#define TIMELIB_INLINE inline
+#endif
@@ -0,0 +1,385 @@
+/// @file counters.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines a group of hardware and software performance counters, read around timed regions.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/stopwatch.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace timelib
+{
+
+/// @brief The events that can be counted.
+enum counter_event_t : unsigned char {
+    event_cycles,           ///< CPU cycles (hardware).
+    event_instructions,     ///< Retired instructions (hardware).
+    event_branch_misses,    ///< Mispredicted branches (hardware).
+    event_cache_misses,     ///< Last-level cache misses (hardware).
+    event_page_faults,      ///< Page faults (software).
+    event_context_switches, ///< Context switches (software).
+    event_cpu_migrations,   ///< Migrations to another processor (software).
+    event_task_clock,       ///< Time spent on the processor, in nanoseconds (software).
+    event_count             ///< The number of events.
+};
+
+/// @brief Returns the name of an event, as used by `perf`.
+/// @param event the event.
+/// @return the name.
+inline auto to_string(counter_event_t event) -> std::string
+{
+    static const char *names[] = {
+        "cycles", "instructions", "branch-misses", "cache-misses",
+        "page-faults", "context-switches", "cpu-migrations", "task-clock"};
+    return (event < event_count) ? names[event] : "unknown";
+}
+
+/// @brief The values of the counters, either absolute or as a delta over a region.
+struct counter_sample_t {
+    /// @brief Constructs a sample where no counter is available.
+    counter_sample_t()
+        : values()
+        , available()
+    {
+        for (unsigned i = 0; i < event_count; ++i) {
+            values[i]    = 0.;
+            available[i] = false;
+        }
+    }
+
+    /// @brief The value of each event, scaled when the counters were multiplexed.
+    double values[event_count];
+    /// @brief If each event has been counted.
+    bool available[event_count];
+
+    /// @brief Checks if an event has been counted.
+    /// @param event the event.
+    /// @return true if the event is available.
+    auto has(counter_event_t event) const -> bool { return available[event]; }
+
+    /// @brief Returns the value of an event.
+    /// @param event the event.
+    /// @return the value, zero if the event is not available.
+    auto get(counter_event_t event) const -> double { return values[event]; }
+
+    /// @brief Returns the instructions per cycle.
+    /// @return the IPC, zero if cycles or instructions are not available.
+    auto ipc() const -> double
+    {
+        if (!available[event_cycles] || !available[event_instructions] || !(values[event_cycles] > 0.)) {
+            return 0.;
+        }
+        return values[event_instructions] / values[event_cycles];
+    }
+
+    /// @brief Computes the difference between two samples.
+    /// @param lhs the later sample.
+    /// @param rhs the earlier sample.
+    /// @return the delta, available only for the events available in both.
+    friend auto operator-(const counter_sample_t &lhs, const counter_sample_t &rhs) -> counter_sample_t
+    {
+        counter_sample_t result;
+        for (unsigned i = 0; i < event_count; ++i) {
+            result.available[i] = lhs.available[i] && rhs.available[i];
+            result.values[i]    = result.available[i] ? (lhs.values[i] - rhs.values[i]) : 0.;
+        }
+        return result;
+    }
+
+    /// @brief Converts the sample to a string (e.g., "cycles=1200 instructions=3400 ...").
+    /// @return the string representation of the sample.
+    auto to_string() const -> std::string
+    {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(0);
+        for (unsigned i = 0; i < event_count; ++i) {
+            if (available[i]) {
+                ss << (ss.tellp() > 0 ? " " : "") << timelib::to_string(static_cast<counter_event_t>(i)) << "="
+                   << values[i];
+            }
+        }
+        if (this->ipc() > 0.) {
+            ss << " ipc=" << std::setprecision(2) << this->ipc();
+        }
+        return ss.str();
+    }
+
+    /// @brief Prints the sample to an output stream.
+    /// @param lhs The output stream.
+    /// @param rhs The sample to print.
+    /// @return The modified output stream.
+    friend auto operator<<(std::ostream &lhs, const counter_sample_t &rhs) -> std::ostream &
+    {
+        return (lhs << rhs.to_string());
+    }
+};
+
+/// @brief A group of performance counters of the calling thread, opened once
+/// with perf_event_open and read with a single read() call.
+/// @details Each event is opened independently, so that an unavailable
+/// hardware counter (e.g., in a container or a virtual machine) does not
+/// prevent the others from being counted: the software events (page faults,
+/// context switches, migrations and task clock) are usually available even
+/// when the hardware ones are not. On other platforms no event is available.
+class CounterGroup
+{
+public:
+    /// @brief Opens the counters for the given events.
+    /// @param events the events to count.
+    explicit CounterGroup(const std::vector<counter_event_t> &events = CounterGroup::all_events())
+        : _leader(-1)
+        , _ids()
+        , _start()
+        , _rounds()
+    {
+        for (unsigned i = 0; i < event_count; ++i) {
+            _fds[i] = -1;
+            _ids[i] = 0;
+        }
+#if defined(__linux__)
+        for (counter_event_t event : events) {
+            if ((event >= event_count) || (_fds[event] >= 0)) {
+                continue;
+            }
+            _fds[event] = CounterGroup::open_event(event, _leader);
+            if (_fds[event] < 0) {
+                continue;
+            }
+            if (_leader < 0) {
+                _leader = _fds[event];
+            }
+            std::uint64_t id = 0;
+            if (ioctl(_fds[event], PERF_EVENT_IOC_ID, &id) == 0) {
+                _ids[event] = id;
+            } else {
+                (void)close(_fds[event]);
+                _leader     = (_leader == _fds[event]) ? -1 : _leader;
+                _fds[event] = -1;
+            }
+        }
+        if (_leader >= 0) {
+            (void)ioctl(_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            (void)ioctl(_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#else
+        (void)events;
+#endif
+        _start = this->read();
+    }
+
+    /// @brief Closes the counters.
+    ~CounterGroup()
+    {
+#if defined(__linux__)
+        for (unsigned i = 0; i < event_count; ++i) {
+            if ((_fds[i] >= 0) && (_fds[i] != _leader)) {
+                (void)close(_fds[i]);
+            }
+        }
+        if (_leader >= 0) {
+            (void)close(_leader);
+        }
+#endif
+    }
+
+    /// @brief Copy constructor (deleted, the counters are owned by a single group).
+    CounterGroup(const CounterGroup &) = delete;
+
+    /// @brief Copy assignment operator (deleted, the counters are owned by a single group).
+    /// @return A reference to this object.
+    auto operator=(const CounterGroup &) -> CounterGroup & = delete;
+
+    /// @brief Returns all the events supported by the group.
+    /// @return the events.
+    static auto all_events() -> std::vector<counter_event_t>
+    {
+        std::vector<counter_event_t> events;
+        for (unsigned i = 0; i < event_count; ++i) {
+            events.push_back(static_cast<counter_event_t>(i));
+        }
+        return events;
+    }
+
+    /// @brief Checks if an event is being counted.
+    /// @param event the event.
+    /// @return true if the event has been opened.
+    auto available(counter_event_t event) const -> bool { return (event < event_count) && (_fds[event] >= 0); }
+
+    /// @brief Reads the current value of all the counters.
+    /// @return the values of the counters.
+    auto read() const -> counter_sample_t
+    {
+        counter_sample_t sample;
+#if defined(__linux__)
+        if (_leader < 0) {
+            return sample;
+        }
+        // Layout of PERF_FORMAT_GROUP | TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING | ID:
+        // nr, time_enabled, time_running, { value, id } * nr.
+        std::uint64_t buffer[3 + (2 * event_count)];
+        ssize_t size = ::read(_leader, buffer, sizeof(buffer));
+        if (size < static_cast<ssize_t>(3 * sizeof(std::uint64_t))) {
+            return sample;
+        }
+        std::uint64_t count = buffer[0];
+        double scale        = 1.;
+        if ((buffer[2] > 0) && (buffer[2] < buffer[1])) {
+            // The group has been multiplexed: extrapolate to the whole time.
+            scale = static_cast<double>(buffer[1]) / static_cast<double>(buffer[2]);
+        }
+        for (std::uint64_t j = 0; (j < count) && (j < event_count); ++j) {
+            for (unsigned i = 0; i < event_count; ++i) {
+                if ((_fds[i] >= 0) && (_ids[i] == buffer[3 + (2 * j) + 1])) {
+                    sample.values[i]    = static_cast<double>(buffer[3 + (2 * j)]) * scale;
+                    sample.available[i] = true;
+                }
+            }
+        }
+#endif
+        return sample;
+    }
+
+    /// @brief Starts a new region, from the current value of the counters.
+    void start() { _start = this->read(); }
+
+    /// @brief Resets the rounds, and starts a new region.
+    void reset()
+    {
+        _rounds.clear();
+        this->start();
+    }
+
+    /// @brief Closes the current region, stores its delta, and starts a new one.
+    /// @return the delta of the counters over the region.
+    auto round() -> counter_sample_t
+    {
+        counter_sample_t now   = this->read();
+        counter_sample_t delta = now - _start;
+        _rounds.push_back(delta);
+        _start = now;
+        return delta;
+    }
+
+    /// @brief Returns the delta of each round.
+    /// @return a const reference to the rounds.
+    auto rounds() const -> const std::vector<counter_sample_t> & { return _rounds; }
+
+    /// @brief Returns the mean delta across rounds.
+    /// @return the mean of each counter.
+    auto mean() const -> counter_sample_t
+    {
+        counter_sample_t result;
+        if (_rounds.empty()) {
+            return result;
+        }
+        for (unsigned i = 0; i < event_count; ++i) {
+            result.available[i] = true;
+            for (const auto &round : _rounds) {
+                result.available[i] = result.available[i] && round.available[i];
+                result.values[i] += round.values[i];
+            }
+            result.values[i] = result.available[i] ? (result.values[i] / static_cast<double>(_rounds.size())) : 0.;
+        }
+        return result;
+    }
+
+private:
+#if defined(__linux__)
+    /// @brief Opens the counter of an event.
+    /// @param event the event.
+    /// @param leader the descriptor of the group leader, -1 to create a new group.
+    /// @return the file descriptor, or -1 if the event is not available.
+    static auto open_event(counter_event_t event, int leader) -> int
+    {
+        static const std::uint32_t types[] = {
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+            PERF_TYPE_SOFTWARE, PERF_TYPE_SOFTWARE, PERF_TYPE_SOFTWARE, PERF_TYPE_SOFTWARE};
+        static const std::uint64_t configs[] = {
+            PERF_COUNT_HW_CPU_CYCLES,     PERF_COUNT_HW_INSTRUCTIONS,     PERF_COUNT_HW_BRANCH_MISSES,
+            PERF_COUNT_HW_CACHE_MISSES,   PERF_COUNT_SW_PAGE_FAULTS,      PERF_COUNT_SW_CONTEXT_SWITCHES,
+            PERF_COUNT_SW_CPU_MIGRATIONS, PERF_COUNT_SW_TASK_CLOCK};
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = types[event];
+        attr.config         = configs[event];
+        attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // The hardware events count the code of the process only. The
+        // software events happen in the kernel (a context switch is never in
+        // user mode), so excluding it would make them read zero.
+        if (attr.type == PERF_TYPE_HARDWARE) {
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+        }
+        // Only the leader starts disabled, the whole group is enabled at once.
+        if (leader < 0) {
+            attr.disabled = 1;
+        }
+        long fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0UL);
+        // Without the privilege to count in the kernel (perf_event_paranoid >= 2),
+        // the page faults and the task clock can still be counted in user mode,
+        // while the context switches and the migrations are not available.
+        if ((fd < 0) && (attr.type == PERF_TYPE_SOFTWARE) && (event != event_context_switches) &&
+            (event != event_cpu_migrations)) {
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            fd                  = syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0UL);
+        }
+        return (fd < 0) ? -1 : static_cast<int>(fd);
+    }
+#endif
+
+    /// @brief The file descriptor of each event, -1 when not available.
+    int _fds[event_count];
+    /// @brief The file descriptor of the group leader.
+    int _leader;
+    /// @brief The identifier of each event, used to decode the group reads.
+    std::uint64_t _ids[event_count];
+    /// @brief The value of the counters at the start of the current region.
+    counter_sample_t _start;
+    /// @brief The delta of each closed region.
+    std::vector<counter_sample_t> _rounds;
+};
+
+/// @brief Runs the function, and samples both the elapsed time and the counters.
+/// @details The clock and the counters are read back to back, around the same region.
+/// @param stopwatch the stopwatch used to retrieve the elapse time.
+/// @param counters the counters used to retrieve the events.
+/// @param function the function to sample.
+/// @return the same stopwatch passed as argument.
+template <class Function>
+inline auto time(Stopwatch &stopwatch, CounterGroup &counters, const Function &function) -> Stopwatch &
+{
+    return detail::time_tracked(stopwatch, counters, 1U, function);
+}
+
+/// @brief Runs the function N times, and samples both the elapsed time and the counters.
+/// @param stopwatch the stopwatch used to retrieve the elapse time.
+/// @param counters the counters used to retrieve the events.
+/// @param function the function to sample.
+/// @return the same stopwatch passed as argument.
+template <std::size_t N, class Function>
+inline auto ntimes(Stopwatch &stopwatch, CounterGroup &counters, const Function &function) -> Stopwatch &
+{
+    return detail::time_tracked(stopwatch, counters, N, function);
+}
+
+} // namespace timelib
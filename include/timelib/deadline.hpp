@@ -0,0 +1,237 @@
+/// @file deadline.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines absolute monotonic deadlines, and the waits built on top of them.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/timer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <future>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace timelib
+{
+
+namespace detail
+{
+
+/// @brief Converts a timespec_t to a duration of the monotonic clock.
+/// @param value the value to convert.
+/// @return the duration.
+inline auto to_clock_duration(const timespec_t &value) -> std::chrono::steady_clock::duration
+{
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::seconds(value.tv_sec) + std::chrono::nanoseconds(value.tv_nsec));
+}
+
+/// @brief Converts a duration of the monotonic clock to a timespec_t.
+/// @param value the value to convert.
+/// @return the timespec_t.
+inline auto to_timespec(const std::chrono::steady_clock::duration &value) -> timespec_t
+{
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(value).count();
+    return timespec_t(
+        static_cast<time_t>(ns / detail::ns_per_second), static_cast<long>(ns % detail::ns_per_second));
+}
+
+} // namespace detail
+
+/// @brief An absolute point in time on the monotonic clock.
+/// @details The deadline is computed once, when it is created. All the waits
+/// that take a Deadline wait until that absolute time point, so spurious
+/// wakeups do not require the clock to be read again, and do not make the
+/// deadline drift.
+class Deadline
+{
+public:
+    /// @brief The monotonic clock used by deadlines.
+    using clock_type = std::chrono::steady_clock;
+    /// @brief The time point type of the monotonic clock.
+    using time_point_type = clock_type::time_point;
+
+    /// @brief Constructs a Deadline from an absolute monotonic time point.
+    /// @param time_point the absolute time point.
+    explicit Deadline(time_point_type time_point)
+        : _time_point(time_point)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Creates a deadline that expires after the given amount of time.
+    /// @param timeout the amount of time, starting from now.
+    /// @return the deadline.
+    static auto after(const timespec_t &timeout) -> Deadline
+    {
+        return Deadline(clock_type::now() + detail::to_clock_duration(timeout));
+    }
+
+    /// @brief Creates a deadline that expires after the given duration.
+    /// @param timeout the amount of time, starting from now.
+    /// @return the deadline.
+    static auto after(const Duration &timeout) -> Deadline { return Deadline::after(timeout.raw()); }
+
+    /// @brief Creates a deadline that expires when the timer reaches its timeout.
+    /// @details If the timer has no timeout, the deadline never expires. The
+    /// remaining time of the timer is sampled only once, here.
+    /// @param timer the timer.
+    /// @return the deadline.
+    static auto from_timer(const Timer &timer) -> Deadline
+    {
+        if (!timer.get_timeout().raw()) {
+            return Deadline::never();
+        }
+        return Deadline::after(timer.remaining());
+    }
+
+    /// @brief Creates a deadline that never expires.
+    /// @return the deadline.
+    static auto never() -> Deadline { return Deadline((time_point_type::max)()); }
+
+    /// @brief Checks if the deadline never expires.
+    /// @return true if the deadline never expires, false otherwise.
+    auto is_never() const -> bool { return _time_point == (time_point_type::max)(); }
+
+    /// @brief Returns the absolute time point of the deadline.
+    /// @return the time point.
+    auto time_point() const -> time_point_type { return _time_point; }
+
+    /// @brief Checks if the deadline has expired.
+    /// @return true if the deadline has expired, false otherwise.
+    auto expired() const -> bool { return !this->is_never() && (clock_type::now() >= _time_point); }
+
+    /// @brief Returns the time left before the deadline expires.
+    /// @return the remaining time, or zero if the deadline has expired.
+    auto remaining() const -> timespec_t
+    {
+        clock_type::time_point now = clock_type::now();
+        if (now >= _time_point) {
+            return timespec_t::zero();
+        }
+        return detail::to_timespec(_time_point - now);
+    }
+
+    /// @brief Returns the deadline as an absolute monotonic timespec_t.
+    /// @return the time since the epoch of the monotonic clock.
+    auto to_timespec() const -> timespec_t { return detail::to_timespec(_time_point.time_since_epoch()); }
+
+private:
+    /// @brief The absolute time point.
+    time_point_type _time_point;
+};
+
+/// @brief Waits on a condition variable until the predicate holds, or the deadline expires.
+/// @param condition the condition variable (std::condition_variable or std::condition_variable_any).
+/// @param lock the lock, which must be owned by the calling thread.
+/// @param deadline the deadline.
+/// @param predicate the predicate to wait for.
+/// @return the value of the predicate when the wait ends.
+template <class Condition, class Lock, class Predicate>
+inline auto wait_until(Condition &condition, Lock &lock, const Deadline &deadline, Predicate predicate) -> bool
+{
+    if (deadline.is_never()) {
+        condition.wait(lock, predicate);
+        return true;
+    }
+    // Spurious wakeups wait again on the same absolute time point.
+    while (!predicate()) {
+        if (condition.wait_until(lock, deadline.time_point()) == std::cv_status::timeout) {
+            return predicate();
+        }
+    }
+    return true;
+}
+
+/// @brief Waits for the future to become ready, or for the deadline to expire.
+/// @param future the future.
+/// @param deadline the deadline.
+/// @return true if the future is ready, false if the deadline expired first.
+template <class T>
+inline auto wait_until(const std::future<T> &future, const Deadline &deadline) -> bool
+{
+    if (deadline.is_never()) {
+        future.wait();
+        return true;
+    }
+    return future.wait_until(deadline.time_point()) == std::future_status::ready;
+}
+
+/// @brief Waits for the shared future to become ready, or for the deadline to expire.
+/// @param future the shared future.
+/// @param deadline the deadline.
+/// @return true if the future is ready, false if the deadline expired first.
+template <class T>
+inline auto wait_until(const std::shared_future<T> &future, const Deadline &deadline) -> bool
+{
+    if (deadline.is_never()) {
+        future.wait();
+        return true;
+    }
+    return future.wait_until(deadline.time_point()) == std::future_status::ready;
+}
+
+/// @brief Waits until the word no longer holds the expected value, or the deadline expires.
+/// @details On Linux the wait is a FUTEX_WAIT_BITSET on the absolute
+/// monotonic deadline, which avoids the mutex and the condition variable
+/// entirely. On the other platforms it falls back to yielding while polling.
+/// Writers must call futex_wake() after changing the word.
+/// @param word the word to wait on.
+/// @param expected the value the word holds while waiting.
+/// @param deadline the deadline.
+/// @return true if the word changed, false if the deadline expired first.
+inline auto futex_wait_until(const std::atomic<int> &word, int expected, const Deadline &deadline) -> bool
+{
+#if defined(__linux__)
+    static_assert(sizeof(std::atomic<int>) == sizeof(int), "std::atomic<int> cannot be used as a futex word.");
+    const timespec_t absolute = deadline.to_timespec();
+    const timespec *timeout   = deadline.is_never() ? nullptr : &absolute;
+    while (word.load(std::memory_order_acquire) == expected) {
+        long result = syscall(
+            SYS_futex, reinterpret_cast<const int *>(&word), FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, expected, timeout,
+            nullptr, FUTEX_BITSET_MATCH_ANY);
+        if ((result == -1) && (errno == ETIMEDOUT)) {
+            return word.load(std::memory_order_acquire) != expected;
+        }
+        // Woken up, interrupted, or the value changed: check the word again.
+    }
+    return true;
+#else
+    while (word.load(std::memory_order_acquire) == expected) {
+        if (deadline.expired()) {
+            return word.load(std::memory_order_acquire) != expected;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+#endif
+}
+
+/// @brief Wakes up the threads waiting on the word with futex_wait_until().
+/// @param word the word the threads are waiting on.
+/// @param count the maximum number of threads to wake up.
+inline void futex_wake(std::atomic<int> &word, int count = INT_MAX)
+{
+#if defined(__linux__)
+    (void)syscall(SYS_futex, reinterpret_cast<int *>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#else
+    // Waiters are polling, there is nothing to wake up.
+    (void)word;
+    (void)count;
+#endif
+}
+
+} // namespace timelib
@@ -0,0 +1,373 @@
+/// @file history_impl.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the storage, the change-point detection and the charts of the benchmark history.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/history.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace timelib
+{
+
+TIMELIB_INLINE auto history_run_t::from_report(const report_t &report, const std::string &label) -> history_run_t
+{
+    history_run_t run;
+    run.date        = report.environment.get("date");
+    run.label       = label;
+    run.environment = report.environment;
+    for (const auto &result : report.results) {
+        std::vector<double> samples = result.samples();
+        if (samples.empty()) {
+            continue;
+        }
+        std::sort(samples.begin(), samples.end());
+        history_point_t point;
+        point.name        = result.name;
+        point.median      = timelib::percentile_sorted(samples, 50.);
+        point.mean        = timelib::mean(samples);
+        point.min         = samples.front();
+        point.p25         = timelib::percentile_sorted(samples, 25.);
+        point.p75         = timelib::percentile_sorted(samples, 75.);
+        point.max         = samples.back();
+        point.repetitions = samples.size();
+        run.points.push_back(point);
+    }
+    return run;
+}
+
+TIMELIB_INLINE auto history_run_t::to_json() const -> std::string
+{
+    detail::json_value_t root = detail::json_value_t::object();
+    root.set("date", detail::json_value_t::string(date));
+    root.set("label", detail::json_value_t::string(label));
+    detail::json_value_t context = detail::json_value_t::object();
+    for (const auto &property : environment.properties) {
+        context.set(property.first, detail::json_value_t::string(property.second));
+    }
+    root.set("context", context);
+    detail::json_value_t benchmarks = detail::json_value_t::array();
+    for (const auto &point : points) {
+        detail::json_value_t entry = detail::json_value_t::object();
+        entry.set("name", detail::json_value_t::string(point.name));
+        entry.set("median_ns", detail::json_value_t::number(point.median * 1e9));
+        entry.set("mean_ns", detail::json_value_t::number(point.mean * 1e9));
+        entry.set("min_ns", detail::json_value_t::number(point.min * 1e9));
+        entry.set("p25_ns", detail::json_value_t::number(point.p25 * 1e9));
+        entry.set("p75_ns", detail::json_value_t::number(point.p75 * 1e9));
+        entry.set("max_ns", detail::json_value_t::number(point.max * 1e9));
+        entry.set("repetitions", detail::json_value_t::number(static_cast<double>(point.repetitions)));
+        benchmarks.push_back(entry);
+    }
+    root.set("benchmarks", benchmarks);
+    return root.dump(-1);
+}
+
+TIMELIB_INLINE auto history_run_t::from_json(const std::string &text) -> history_run_t
+{
+    detail::json_value_t root = detail::json_value_t::parse(text);
+    history_run_t run;
+    run.date  = root.at("date").as_string();
+    run.label = root.at("label").as_string();
+    if (root.contains("context")) {
+        for (const auto &member : root.at("context").members()) {
+            run.environment.set(member.first, member.second.as_string());
+        }
+    }
+    for (const auto &entry : root.at("benchmarks").elements()) {
+        history_point_t point;
+        point.name        = entry.at("name").as_string();
+        point.median      = entry.at("median_ns").as_number() / 1e9;
+        point.mean        = entry.at("mean_ns").as_number() / 1e9;
+        point.min         = entry.at("min_ns").as_number() / 1e9;
+        point.p25         = entry.at("p25_ns").as_number() / 1e9;
+        point.p75         = entry.at("p75_ns").as_number() / 1e9;
+        point.max         = entry.at("max_ns").as_number() / 1e9;
+        point.repetitions = static_cast<std::size_t>(entry.at("repetitions").as_number());
+        run.points.push_back(point);
+    }
+    return run;
+}
+
+TIMELIB_INLINE void append_history(const std::string &path, const history_run_t &run)
+{
+    std::ofstream file(path.c_str(), std::ios::out | std::ios::app);
+    if (!file) {
+        throw std::runtime_error("Cannot open '" + path + "' for writing.");
+    }
+    file << run.to_json() << "\n";
+    if (!file) {
+        throw std::runtime_error("Cannot write '" + path + "'.");
+    }
+}
+
+TIMELIB_INLINE auto load_history(const std::string &path) -> std::vector<history_run_t>
+{
+    std::ifstream file(path.c_str());
+    if (!file) {
+        throw std::runtime_error("Cannot open '" + path + "' for reading.");
+    }
+    std::vector<history_run_t> runs;
+    std::string line;
+    for (std::size_t number = 1; std::getline(file, line); ++number) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        try {
+            runs.push_back(history_run_t::from_json(line));
+        } catch (const std::exception &e) {
+            throw std::runtime_error(path + ":" + std::to_string(number) + ": " + e.what());
+        }
+    }
+    return runs;
+}
+
+namespace detail
+{
+
+TIMELIB_INLINE void segment_series(
+    const std::vector<double> &values,
+    std::size_t begin,
+    std::size_t end,
+    const change_point_options_t &options,
+    std::vector<change_point_t> &result)
+{
+    std::size_t min_segment = std::max<std::size_t>(options.min_segment, 2);
+    if ((end - begin) < (2 * min_segment)) {
+        return;
+    }
+    // The split with the largest t statistic is the most likely change.
+    change_point_t best = {0, 0., 0., 0., 1.};
+    double best_statistic = 0.;
+    for (std::size_t split = begin + min_segment; split + min_segment <= end; ++split) {
+        auto middle = values.begin() + static_cast<std::ptrdiff_t>(split);
+        std::vector<double> left(values.begin() + static_cast<std::ptrdiff_t>(begin), middle);
+        std::vector<double> right(middle, values.begin() + static_cast<std::ptrdiff_t>(end));
+        test_result_t test = timelib::welch_t_test(left, right);
+        if (std::abs(test.statistic) > best_statistic) {
+            best_statistic = std::abs(test.statistic);
+            best.index     = split;
+            best.before    = timelib::mean(left);
+            best.after     = timelib::mean(right);
+            best.p_value   = test.p_value;
+        }
+    }
+    if ((best_statistic <= 0.) || (best.p_value >= options.alpha) || !(best.before > 0.)) {
+        return;
+    }
+    best.change = 100. * ((best.after - best.before) / best.before);
+    if (std::abs(best.change) < options.threshold) {
+        return;
+    }
+    detail::segment_series(values, begin, best.index, options, result);
+    result.push_back(best);
+    detail::segment_series(values, best.index, end, options, result);
+}
+
+} // namespace detail
+
+TIMELIB_INLINE auto detect_change_points(
+    const std::vector<double> &values,
+    const change_point_options_t &options) -> std::vector<change_point_t>
+{
+    std::vector<change_point_t> result;
+    detail::segment_series(values, 0, values.size(), options, result);
+    return result;
+}
+
+TIMELIB_INLINE auto history_series_t::to_ascii(std::size_t width, std::size_t height) const -> std::string
+{
+    std::stringstream ss;
+    ss << name << "\n";
+    if (points.empty() || (height < 2)) {
+        return ss.str();
+    }
+    // At least the last run is drawn, so that the first one drawn exists.
+    width             = std::max(width, static_cast<std::size_t>(1));
+    std::size_t first = (points.size() > width) ? (points.size() - width) : 0;
+    double low        = points[first].p25;
+    double high       = points[first].p75;
+    for (std::size_t i = first; i < points.size(); ++i) {
+        low  = std::min(low, std::min(points[i].p25, points[i].median));
+        high = std::max(high, std::max(points[i].p75, points[i].median));
+    }
+    double span = (high > low) ? (high - low) : 1.;
+    auto row_of = [&](double value) {
+        return static_cast<std::size_t>(std::lround(((value - low) / span) * static_cast<double>(height - 1)));
+    };
+    std::vector<std::string> rows(height, std::string(points.size() - first, ' '));
+    for (std::size_t i = first; i < points.size(); ++i) {
+        for (std::size_t row = row_of(points[i].p25); row <= row_of(points[i].p75); ++row) {
+            rows[row][i - first] = ':';
+        }
+        rows[row_of(points[i].median)][i - first] = '*';
+    }
+    std::string markers(points.size() - first, ' ');
+    for (const auto &change : change_points) {
+        if (change.index >= first) {
+            markers[change.index - first] = '^';
+        }
+    }
+    for (std::size_t row = height; row-- > 0;) {
+        std::string label;
+        if (row == (height - 1)) {
+            label = detail::format_time(high);
+        } else if (row == 0) {
+            label = detail::format_time(low);
+        }
+        ss << std::setw(12) << label << " |" << rows[row] << "\n";
+    }
+    ss << std::setw(12) << "" << " +" << std::string(points.size() - first, '-') << "\n";
+    ss << std::setw(12) << "" << "  " << markers << "\n";
+    for (const auto &change : change_points) {
+        ss << "  change at " << labels[change.index] << ": " << detail::format_time(change.before) << " -> "
+           << detail::format_time(change.after) << " (" << std::showpos << std::fixed << std::setprecision(1)
+           << change.change << std::noshowpos << "%, p=" << std::setprecision(4) << change.p_value << ")\n";
+    }
+    return ss.str();
+}
+
+TIMELIB_INLINE auto history_names(const std::vector<history_run_t> &runs) -> std::vector<std::string>
+{
+    std::vector<std::string> names;
+    for (const auto &run : runs) {
+        for (const auto &point : run.points) {
+            if (std::find(names.begin(), names.end(), point.name) == names.end()) {
+                names.push_back(point.name);
+            }
+        }
+    }
+    return names;
+}
+
+TIMELIB_INLINE auto history_series(
+    const std::vector<history_run_t> &runs,
+    const std::string &name,
+    const change_point_options_t &options) -> history_series_t
+{
+    history_series_t series;
+    series.name = name;
+    for (const auto &run : runs) {
+        const history_point_t *point = run.find(name);
+        if (point != nullptr) {
+            series.labels.push_back(run.label.empty() ? run.date : run.label);
+            series.points.push_back(*point);
+        }
+    }
+    series.change_points = timelib::detect_change_points(series.medians(), options);
+    return series;
+}
+
+namespace detail
+{
+
+TIMELIB_INLINE auto html_escape(const std::string &text) -> std::string
+{
+    std::string result;
+    for (char c : text) {
+        switch (c) {
+        case '&':
+            result += "&amp;";
+            break;
+        case '<':
+            result += "&lt;";
+            break;
+        case '>':
+            result += "&gt;";
+            break;
+        case '"':
+            result += "&quot;";
+            break;
+        default:
+            result += c;
+        }
+    }
+    return result;
+}
+
+} // namespace detail
+
+TIMELIB_INLINE auto render_history_html(
+    const std::vector<history_series_t> &series,
+    const std::string &title) -> std::string
+{
+    const double width  = 800.;
+    const double height = 240.;
+    const double margin = 70.;
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    ss << "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n<title>" << detail::html_escape(title)
+       << "</title>\n<style>\nbody { font-family: sans-serif; margin: 2em; }\n"
+       << "table { border-collapse: collapse; } td, th { padding: 2px 8px; border-bottom: 1px solid #ddd; }\n"
+       << "svg { background: #fafafa; border: 1px solid #ddd; }\n</style>\n</head>\n<body>\n<h1>"
+       << detail::html_escape(title) << "</h1>\n";
+    for (const auto &serie : series) {
+        ss << "<h2>" << detail::html_escape(serie.name) << "</h2>\n";
+        if (serie.points.empty()) {
+            continue;
+        }
+        double low  = serie.points[0].min;
+        double high = serie.points[0].max;
+        for (const auto &point : serie.points) {
+            low  = std::min(low, point.min);
+            high = std::max(high, point.max);
+        }
+        double span = (high > low) ? (high - low) : 1.;
+        double step = (width - margin - 10.) / static_cast<double>(std::max<std::size_t>(serie.points.size(), 1));
+        auto x_of   = [&](std::size_t index) { return margin + (step * (static_cast<double>(index) + 0.5)); };
+        auto y_of   = [&](double value) { return 10. + ((height - 30.) * (1. - ((value - low) / span))); };
+        ss << "<svg width=\"" << width << "\" height=\"" << height << "\" xmlns=\"http://www.w3.org/2000/svg\">\n";
+        ss << "<text x=\"4\" y=\"" << y_of(high) + 4. << "\" font-size=\"11\">" << detail::format_time(high)
+           << "</text>\n";
+        ss << "<text x=\"4\" y=\"" << y_of(low) + 4. << "\" font-size=\"11\">" << detail::format_time(low)
+           << "</text>\n";
+        for (std::size_t i = 0; i < serie.points.size(); ++i) {
+            const history_point_t &point = serie.points[i];
+            ss << "<line x1=\"" << x_of(i) << "\" y1=\"" << y_of(point.max) << "\" x2=\"" << x_of(i) << "\" y2=\""
+               << y_of(point.min) << "\" stroke=\"#9ecae1\"/>\n";
+            ss << "<rect x=\"" << x_of(i) - (step * 0.3) << "\" y=\"" << y_of(point.p75) << "\" width=\""
+               << step * 0.6 << "\" height=\"" << std::max(y_of(point.p25) - y_of(point.p75), 1.)
+               << "\" fill=\"#9ecae1\"><title>" << detail::html_escape(serie.labels[i]) << ": "
+               << detail::format_time(point.median) << "</title></rect>\n";
+        }
+        ss << "<polyline fill=\"none\" stroke=\"#08519c\" stroke-width=\"1.5\" points=\"";
+        for (std::size_t i = 0; i < serie.points.size(); ++i) {
+            ss << x_of(i) << "," << y_of(serie.points[i].median) << " ";
+        }
+        ss << "\"/>\n";
+        for (const auto &change : serie.change_points) {
+            double x = x_of(change.index) - (step / 2.);
+            ss << "<line x1=\"" << x << "\" y1=\"0\" x2=\"" << x << "\" y2=\"" << height - 20.
+               << "\" stroke=\"#de2d26\" stroke-dasharray=\"4,3\"/>\n";
+        }
+        ss << "<text x=\"" << margin << "\" y=\"" << height - 4. << "\" font-size=\"11\">"
+           << detail::html_escape(serie.labels.front()) << "</text>\n";
+        ss << "<text x=\"" << width - 10. << "\" y=\"" << height - 4. << "\" font-size=\"11\" text-anchor=\"end\">"
+           << detail::html_escape(serie.labels.back()) << "</text>\n";
+        ss << "</svg>\n";
+        if (!serie.change_points.empty()) {
+            ss << "<table>\n<tr><th>run</th><th>before</th><th>after</th><th>change</th><th>p</th></tr>\n";
+            for (const auto &change : serie.change_points) {
+                ss << "<tr><td>" << detail::html_escape(serie.labels[change.index]) << "</td><td>"
+                   << detail::format_time(change.before) << "</td><td>" << detail::format_time(change.after)
+                   << "</td><td>" << std::showpos << change.change << std::noshowpos << "%</td><td>"
+                   << std::setprecision(4) << change.p_value << std::setprecision(1) << "</td></tr>\n";
+            }
+            ss << "</table>\n";
+        }
+    }
+    ss << "</body>\n</html>\n";
+    return ss.str();
+}
+
+} // namespace timelib
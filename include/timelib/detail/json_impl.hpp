@@ -0,0 +1,295 @@
+/// @file json_impl.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the writer and the parser of the JSON values.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/json.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace timelib
+{
+
+namespace detail
+{
+
+TIMELIB_INLINE auto json_value_t::dump(int indent) const -> std::string
+{
+    std::string output;
+    this->dump(output, indent, 0);
+    return output;
+}
+
+TIMELIB_INLINE auto json_value_t::parse(const std::string &text) -> json_value_t
+{
+    std::size_t position = 0;
+    json_value_t value   = json_value_t::parse_value(text, position);
+    json_value_t::skip_whitespace(text, position);
+    if (position != text.size()) {
+        json_value_t::fail("unexpected trailing characters", position);
+    }
+    return value;
+}
+
+TIMELIB_INLINE void json_value_t::dump_string(std::string &output, const std::string &value)
+{
+    output += '"';
+    for (char c : value) {
+        switch (c) {
+        case '"':
+            output += "\\\"";
+            break;
+        case '\\':
+            output += "\\\\";
+            break;
+        case '\n':
+            output += "\\n";
+            break;
+        case '\r':
+            output += "\\r";
+            break;
+        case '\t':
+            output += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20U) {
+                char buffer[8];
+                (void)std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+                output += buffer;
+            } else {
+                output += c;
+            }
+        }
+    }
+    output += '"';
+}
+
+TIMELIB_INLINE void json_value_t::dump_newline(std::string &output, int indent, int level)
+{
+    if (indent >= 0) {
+        output += '\n';
+        output.append(static_cast<std::size_t>(indent * level), ' ');
+    }
+}
+
+TIMELIB_INLINE void json_value_t::dump(std::string &output, int indent, int level) const
+{
+    switch (_type) {
+    case bool_type:
+        output += _bool ? "true" : "false";
+        break;
+    case number_type: {
+        // JSON has no representation of NaN and infinity.
+        if (!std::isfinite(_number)) {
+            output += "null";
+            break;
+        }
+        char buffer[32];
+        (void)std::snprintf(buffer, sizeof(buffer), "%.17g", _number);
+        output += buffer;
+        break;
+    }
+    case string_type:
+        json_value_t::dump_string(output, _string);
+        break;
+    case array_type:
+        output += '[';
+        for (std::size_t i = 0; i < _elements.size(); ++i) {
+            output += (i > 0) ? "," : "";
+            json_value_t::dump_newline(output, indent, level + 1);
+            _elements[i].dump(output, indent, level + 1);
+        }
+        if (!_elements.empty()) {
+            json_value_t::dump_newline(output, indent, level);
+        }
+        output += ']';
+        break;
+    case object_type:
+        output += '{';
+        for (std::size_t i = 0; i < _members.size(); ++i) {
+            output += (i > 0) ? "," : "";
+            json_value_t::dump_newline(output, indent, level + 1);
+            json_value_t::dump_string(output, _members[i].first);
+            output += (indent >= 0) ? ": " : ":";
+            _members[i].second.dump(output, indent, level + 1);
+        }
+        if (!_members.empty()) {
+            json_value_t::dump_newline(output, indent, level);
+        }
+        output += '}';
+        break;
+    case null_type:
+    default:
+        output += "null";
+        break;
+    }
+}
+
+TIMELIB_INLINE void json_value_t::fail(const std::string &message, std::size_t position)
+{
+    throw std::runtime_error("Invalid JSON at offset " + std::to_string(position) + ": " + message + ".");
+}
+
+TIMELIB_INLINE void json_value_t::skip_whitespace(const std::string &text, std::size_t &position)
+{
+    while ((position < text.size()) &&
+           ((text[position] == ' ') || (text[position] == '\n') || (text[position] == '\r') ||
+            (text[position] == '\t'))) {
+        ++position;
+    }
+}
+
+TIMELIB_INLINE void json_value_t::consume(const std::string &text, std::size_t &position, const char *keyword)
+{
+    std::string expected(keyword);
+    if (text.compare(position, expected.size(), expected) != 0) {
+        json_value_t::fail("expected '" + expected + "'", position);
+    }
+    position += expected.size();
+}
+
+TIMELIB_INLINE auto json_value_t::parse_string(const std::string &text, std::size_t &position) -> std::string
+{
+    json_value_t::consume(text, position, "\"");
+    std::string result;
+    while (position < text.size()) {
+        char c = text[position++];
+        if (c == '"') {
+            return result;
+        }
+        if (c != '\\') {
+            result += c;
+            continue;
+        }
+        if (position >= text.size()) {
+            break;
+        }
+        char escape = text[position++];
+        switch (escape) {
+        case 'n':
+            result += '\n';
+            break;
+        case 'r':
+            result += '\r';
+            break;
+        case 't':
+            result += '\t';
+            break;
+        case 'b':
+            result += '\b';
+            break;
+        case 'f':
+            result += '\f';
+            break;
+        case 'u': {
+            if ((position + 4) > text.size()) {
+                json_value_t::fail("truncated unicode escape", position);
+            }
+            auto code = static_cast<unsigned>(std::strtoul(text.substr(position, 4).c_str(), nullptr, 16));
+            position += 4;
+            // Encode the code point (from the basic multilingual plane) as UTF-8.
+            if (code < 0x80U) {
+                result += static_cast<char>(code);
+            } else if (code < 0x800U) {
+                result += static_cast<char>(0xC0U | (code >> 6U));
+                result += static_cast<char>(0x80U | (code & 0x3FU));
+            } else {
+                result += static_cast<char>(0xE0U | (code >> 12U));
+                result += static_cast<char>(0x80U | ((code >> 6U) & 0x3FU));
+                result += static_cast<char>(0x80U | (code & 0x3FU));
+            }
+            break;
+        }
+        default:
+            result += escape;
+            break;
+        }
+    }
+    json_value_t::fail("unterminated string", position);
+    return result;
+}
+
+TIMELIB_INLINE auto json_value_t::parse_value(const std::string &text, std::size_t &position) -> json_value_t
+{
+    json_value_t::skip_whitespace(text, position);
+    if (position >= text.size()) {
+        json_value_t::fail("unexpected end of input", position);
+    }
+    char c = text[position];
+    if (c == '{') {
+        json_value_t result = json_value_t::object();
+        ++position;
+        json_value_t::skip_whitespace(text, position);
+        if ((position < text.size()) && (text[position] == '}')) {
+            ++position;
+            return result;
+        }
+        while (true) {
+            json_value_t::skip_whitespace(text, position);
+            std::string key = json_value_t::parse_string(text, position);
+            json_value_t::skip_whitespace(text, position);
+            json_value_t::consume(text, position, ":");
+            result._members.emplace_back(key, json_value_t::parse_value(text, position));
+            json_value_t::skip_whitespace(text, position);
+            if ((position < text.size()) && (text[position] == ',')) {
+                ++position;
+                continue;
+            }
+            json_value_t::consume(text, position, "}");
+            return result;
+        }
+    }
+    if (c == '[') {
+        json_value_t result = json_value_t::array();
+        ++position;
+        json_value_t::skip_whitespace(text, position);
+        if ((position < text.size()) && (text[position] == ']')) {
+            ++position;
+            return result;
+        }
+        while (true) {
+            result._elements.push_back(json_value_t::parse_value(text, position));
+            json_value_t::skip_whitespace(text, position);
+            if ((position < text.size()) && (text[position] == ',')) {
+                ++position;
+                continue;
+            }
+            json_value_t::consume(text, position, "]");
+            return result;
+        }
+    }
+    if (c == '"') {
+        return json_value_t::string(json_value_t::parse_string(text, position));
+    }
+    if (c == 't') {
+        json_value_t::consume(text, position, "true");
+        return json_value_t::boolean(true);
+    }
+    if (c == 'f') {
+        json_value_t::consume(text, position, "false");
+        return json_value_t::boolean(false);
+    }
+    if (c == 'n') {
+        json_value_t::consume(text, position, "null");
+        return json_value_t();
+    }
+    const char *begin = text.c_str() + position;
+    char *end         = nullptr;
+    double number     = std::strtod(begin, &end);
+    if (end == begin) {
+        json_value_t::fail("unexpected character", position);
+    }
+    position += static_cast<std::size_t>(end - begin);
+    return json_value_t::number(number);
+}
+
+} // namespace detail
+
+} // namespace timelib
@@ -0,0 +1,446 @@
+/// @file report_impl.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the environment probes, the report files and the comparison against a baseline.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/report.hpp"
+
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+
+namespace timelib
+{
+
+namespace detail
+{
+
+TIMELIB_INLINE auto utc_timestamp() -> std::string
+{
+    std::time_t now = std::time(nullptr);
+    std::tm utc     = {};
+#if defined(_WIN32)
+    (void)gmtime_s(&utc, &now);
+#else
+    (void)gmtime_r(&now, &utc);
+#endif
+    char buffer[32];
+    (void)std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return std::string(buffer);
+}
+
+TIMELIB_INLINE auto host_name() -> std::string
+{
+#if defined(_WIN32)
+    const char *name = std::getenv("COMPUTERNAME");
+    return (name != nullptr) ? std::string(name) : std::string();
+#else
+    char buffer[256] = {};
+    if (gethostname(buffer, sizeof(buffer) - 1) != 0) {
+        return std::string();
+    }
+    return std::string(buffer);
+#endif
+}
+
+TIMELIB_INLINE auto operating_system() -> std::string
+{
+#if defined(_WIN32)
+    return "Windows";
+#else
+    struct utsname name = {};
+    if (uname(&name) != 0) {
+        return std::string();
+    }
+    return std::string(name.sysname) + " " + name.release + " " + name.machine;
+#endif
+}
+
+TIMELIB_INLINE auto read_first_line(const std::string &path) -> std::string
+{
+    std::ifstream file(path.c_str());
+    std::string line;
+    if (!file || !std::getline(file, line)) {
+        return std::string();
+    }
+    return line;
+}
+
+TIMELIB_INLINE auto cpu_model() -> std::string
+{
+    std::ifstream file("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(file, line)) {
+        if ((line.compare(0, 10, "model name") == 0) || (line.compare(0, 9, "Processor") == 0)) {
+            std::size_t value = line.find_first_not_of(' ', line.find(':') + 1);
+            return (value != std::string::npos) ? line.substr(value) : std::string();
+        }
+    }
+    return std::string();
+}
+
+TIMELIB_INLINE auto physical_cores() -> std::size_t
+{
+    std::vector<std::pair<std::string, std::string> > cores;
+    for (std::size_t cpu = 0;; ++cpu) {
+        std::string topology = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+        std::string core     = detail::read_first_line(topology + "core_id");
+        if (core.empty()) {
+            break;
+        }
+        cores.emplace_back(detail::read_first_line(topology + "physical_package_id"), core);
+    }
+    std::sort(cores.begin(), cores.end());
+    return static_cast<std::size_t>(std::unique(cores.begin(), cores.end()) - cores.begin());
+}
+
+TIMELIB_INLINE auto cpu_caches() -> std::string
+{
+    std::string result;
+    for (int index = 0; index < 8; ++index) {
+        std::string cache = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+        std::string level = detail::read_first_line(cache + "level");
+        if (level.empty()) {
+            break;
+        }
+        std::string type = detail::read_first_line(cache + "type");
+        std::string name = "L" + level + ((type == "Data") ? "d" : (type == "Instruction") ? "i" : "");
+        result += (result.empty() ? "" : ", ") + name + " " + detail::read_first_line(cache + "size");
+    }
+    return result;
+}
+
+TIMELIB_INLINE auto governors() -> std::string
+{
+    std::vector<std::string> governors = timelib::cpu_governors();
+    std::sort(governors.begin(), governors.end());
+    governors.erase(std::unique(governors.begin(), governors.end()), governors.end());
+    std::string result;
+    for (const auto &governor : governors) {
+        result += (result.empty() ? "" : ",") + governor;
+    }
+    return result;
+}
+
+TIMELIB_INLINE auto csv_escape(const std::string &field) -> std::string
+{
+    if (field.find_first_of(",\"\n") == std::string::npos) {
+        return field;
+    }
+    std::string result = "\"";
+    for (char c : field) {
+        result += (c == '"') ? std::string("\"\"") : std::string(1, c);
+    }
+    return result + "\"";
+}
+
+} // namespace detail
+
+TIMELIB_INLINE auto compare_environments(const environment_t &baseline, const environment_t &current)
+    -> std::vector<std::string>
+{
+    std::vector<std::string> keys;
+    for (const auto &property : baseline.properties) {
+        keys.push_back(property.first);
+    }
+    for (const auto &property : current.properties) {
+        if (std::find(keys.begin(), keys.end(), property.first) == keys.end()) {
+            keys.push_back(property.first);
+        }
+    }
+    std::vector<std::string> differences;
+    for (const auto &key : keys) {
+        if ((key == "date") || (key == "seed")) {
+            continue;
+        }
+        std::string before = baseline.get(key);
+        std::string after  = current.get(key);
+        if (before != after) {
+            differences.push_back(
+                "The " + key + " differs from the baseline: '" + before + "' (baseline) vs '" + after +
+                "' (current).");
+        }
+    }
+    return differences;
+}
+
+TIMELIB_INLINE auto report_t::to_json() const -> std::string
+{
+    detail::json_value_t root    = detail::json_value_t::object();
+    detail::json_value_t context = detail::json_value_t::object();
+    detail::json_value_t entries = detail::json_value_t::array();
+    for (const auto &property : environment.properties) {
+        context.set(property.first, detail::json_value_t::string(property.second));
+    }
+    for (const auto &result : results) {
+        detail::json_value_t entry       = detail::json_value_t::object();
+        detail::json_value_t repetitions = detail::json_value_t::array();
+        for (const auto &repetition : result.repetitions) {
+            detail::json_value_t item = detail::json_value_t::object();
+            item.set("iterations", detail::json_value_t::number(static_cast<double>(repetition.iterations)));
+            item.set(
+                "elapsed_ns",
+                detail::json_value_t::number(static_cast<double>(repetition.elapsed.to_nanoseconds<long long>())));
+            item.set("time_per_iteration_ns", detail::json_value_t::number(repetition.time_per_iteration() * 1e9));
+            const resource_usage_t &usage = repetition.usage;
+            item.set("minor_faults", detail::json_value_t::number(static_cast<double>(usage.minor_faults)));
+            item.set("major_faults", detail::json_value_t::number(static_cast<double>(usage.major_faults)));
+            item.set(
+                "voluntary_switches", detail::json_value_t::number(static_cast<double>(usage.voluntary_switches)));
+            item.set(
+                "involuntary_switches",
+                detail::json_value_t::number(static_cast<double>(usage.involuntary_switches)));
+            repetitions.push_back(item);
+        }
+        entry.set("name", detail::json_value_t::string(result.name));
+        entry.set("mean_ns", detail::json_value_t::number(result.mean() * 1e9));
+        entry.set("median_ns", detail::json_value_t::number(timelib::median(result.samples()) * 1e9));
+        entry.set("stddev_ns", detail::json_value_t::number(result.stddev() * 1e9));
+        if (!result.baseline.empty()) {
+            confidence_interval_t<double> corrected = result.corrected();
+            entry.set("overhead_ns", detail::json_value_t::number(result.overhead() * 1e9));
+            entry.set("corrected_ns", detail::json_value_t::number(corrected.estimate * 1e9));
+            entry.set("corrected_error_ns", detail::json_value_t::number(corrected.half_width() * 1e9));
+        }
+        if (result.items_per_iteration > 0) {
+            throughput_t items = result.throughput(unit_items);
+            entry.set(
+                "items_per_iteration",
+                detail::json_value_t::number(static_cast<double>(result.items_per_iteration)));
+            entry.set("items_per_second", detail::json_value_t::number(items.aggregate));
+            entry.set("items_per_second_error", detail::json_value_t::number(items.interval.half_width()));
+        }
+        if (result.bytes_per_iteration > 0) {
+            throughput_t bytes = result.throughput(unit_bytes);
+            entry.set(
+                "bytes_per_iteration",
+                detail::json_value_t::number(static_cast<double>(result.bytes_per_iteration)));
+            entry.set("bytes_per_second", detail::json_value_t::number(bytes.aggregate));
+            entry.set("bytes_per_second_error", detail::json_value_t::number(bytes.interval.half_width()));
+        }
+        entry.set("repetitions", repetitions);
+        if (!result.warnings.empty()) {
+            detail::json_value_t warnings = detail::json_value_t::array();
+            for (const auto &warning : result.warnings) {
+                warnings.push_back(detail::json_value_t::string(warning));
+            }
+            entry.set("warnings", warnings);
+        }
+        entries.push_back(entry);
+    }
+    root.set("context", context);
+    root.set("benchmarks", entries);
+    return root.dump() + "\n";
+}
+
+TIMELIB_INLINE auto report_t::to_csv() const -> std::string
+{
+    std::stringstream ss;
+    for (const auto &property : environment.properties) {
+        ss << "# " << property.first << ": " << property.second << "\n";
+    }
+    ss << "name,repetition,iterations,elapsed_ns,time_per_iteration_ns\n";
+    for (const auto &result : results) {
+        for (std::size_t i = 0; i < result.repetitions.size(); ++i) {
+            const repetition_t &repetition = result.repetitions[i];
+            ss << detail::csv_escape(result.name) << "," << i << "," << repetition.iterations << ","
+               << repetition.elapsed.to_nanoseconds<long long>() << "," << std::setprecision(17)
+               << (repetition.time_per_iteration() * 1e9) << "\n";
+        }
+    }
+    return ss.str();
+}
+
+TIMELIB_INLINE auto report_t::to_string() const -> std::string
+{
+    std::stringstream ss;
+    for (const auto &result : results) {
+        ss << result << "\n";
+    }
+    return ss.str();
+}
+
+TIMELIB_INLINE auto report_t::format(output_format_t format) const -> std::string
+{
+    if (format == json) {
+        return this->to_json();
+    }
+    if (format == csv) {
+        return this->to_csv();
+    }
+    return this->to_string();
+}
+
+TIMELIB_INLINE void report_t::save(const std::string &path, output_format_t format) const
+{
+    std::ofstream file(path.c_str(), std::ios::out | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Cannot open '" + path + "' for writing.");
+    }
+    file << this->format(format);
+    if (!file) {
+        throw std::runtime_error("Cannot write '" + path + "'.");
+    }
+}
+
+TIMELIB_INLINE auto report_t::from_json(const std::string &text) -> report_t
+{
+    report_t report;
+    detail::json_value_t root = detail::json_value_t::parse(text);
+    if (root.contains("context")) {
+        for (const auto &member : root.at("context").members()) {
+            report.environment.set(member.first, member.second.as_string());
+        }
+    }
+    for (const auto &entry : root.at("benchmarks").elements()) {
+        benchmark_result_t result;
+        result.name = entry.at("name").as_string();
+        for (const auto &item : entry.at("repetitions").elements()) {
+            auto elapsed = static_cast<long long>(item.at("elapsed_ns").as_number());
+            repetition_t repetition;
+            repetition.iterations = static_cast<std::size_t>(item.at("iterations").as_number());
+            repetition.elapsed    = timespec_t(
+                static_cast<time_t>(elapsed / detail::ns_per_second),
+                static_cast<long>(elapsed % detail::ns_per_second));
+            if (item.contains("involuntary_switches")) {
+                repetition.usage.minor_faults = static_cast<long>(item.at("minor_faults").as_number());
+                repetition.usage.major_faults = static_cast<long>(item.at("major_faults").as_number());
+                repetition.usage.voluntary_switches =
+                    static_cast<long>(item.at("voluntary_switches").as_number());
+                repetition.usage.involuntary_switches =
+                    static_cast<long>(item.at("involuntary_switches").as_number());
+            }
+            result.repetitions.push_back(repetition);
+        }
+        if (entry.contains("items_per_iteration")) {
+            result.items_per_iteration = static_cast<std::size_t>(entry.at("items_per_iteration").as_number());
+        }
+        if (entry.contains("bytes_per_iteration")) {
+            result.bytes_per_iteration = static_cast<std::size_t>(entry.at("bytes_per_iteration").as_number());
+        }
+        if (entry.contains("warnings")) {
+            for (const auto &warning : entry.at("warnings").elements()) {
+                result.warnings.push_back(warning.as_string());
+            }
+        }
+        report.results.push_back(result);
+    }
+    return report;
+}
+
+TIMELIB_INLINE auto report_t::load(const std::string &path) -> report_t
+{
+    std::ifstream file(path.c_str());
+    if (!file) {
+        throw std::runtime_error("Cannot open '" + path + "' for reading.");
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return report_t::from_json(ss.str());
+}
+
+TIMELIB_INLINE auto baseline_comparison_t::to_string() const -> std::string
+{
+    static const char *labels[] = {"unchanged", "improved", "REGRESSED", "missing", "incomparable"};
+    std::stringstream ss;
+    ss << std::left << std::setw(32) << "benchmark" << std::right << std::setw(14) << "baseline" << std::setw(14)
+       << "current" << std::setw(10) << "change" << std::setw(10) << "p" << std::setw(14) << "status"
+       << "\n";
+    for (const auto &entry : entries) {
+        ss << std::left << std::setw(32) << entry.name << std::right;
+        if (entry.status == missing) {
+            // Only one of the two runs has the benchmark.
+            ss << std::setw(14) << ((entry.baseline > 0.) ? detail::format_time(entry.baseline) : "-") << std::setw(14)
+               << ((entry.current > 0.) ? detail::format_time(entry.current) : "-") << std::setw(10) << "-"
+               << std::setw(10) << "-";
+        } else if (entry.status == incomparable) {
+            ss << std::setw(14) << detail::format_time(entry.baseline) << std::setw(14)
+               << detail::format_time(entry.current) << std::setw(10) << "-" << std::setw(10) << "-";
+        } else {
+            ss << std::setw(14) << detail::format_time(entry.baseline) << std::setw(14)
+               << detail::format_time(entry.current) << std::setw(9) << std::fixed << std::setprecision(1)
+               << entry.change << "%" << std::setw(10) << std::setprecision(3) << entry.result.p_value;
+        }
+        ss << std::setw(14) << labels[entry.status] << "\n";
+    }
+    for (const auto &warning : warnings) {
+        ss << "warning: " << warning << "\n";
+    }
+    return ss.str();
+}
+
+TIMELIB_INLINE auto compare_to_baseline(
+    const report_t &baseline,
+    const report_t &current,
+    const baseline_options_t &options) -> baseline_comparison_t
+{
+    baseline_comparison_t comparison;
+    comparison.warnings = timelib::compare_environments(baseline.environment, current.environment);
+    for (const auto &result : current.results) {
+        baseline_entry_t entry;
+        entry.name             = result.name;
+        entry.baseline         = 0.;
+        entry.current          = result.repetitions.empty() ? 0. : timelib::median(result.samples());
+        entry.change           = 0.;
+        entry.result.statistic = 0.;
+        entry.result.p_value   = 1.;
+        entry.status           = missing;
+        const benchmark_result_t *reference = baseline.find(result.name);
+        if ((reference != nullptr) && !reference->repetitions.empty() && !result.repetitions.empty()) {
+            std::vector<double> before = reference->samples();
+            std::vector<double> after  = result.samples();
+            entry.baseline             = timelib::median(before);
+            // A baseline of zero (e.g., the code was optimized away) leaves no change to compute.
+            if (!(entry.baseline > 0.)) {
+                entry.status = incomparable;
+                comparison.entries.push_back(entry);
+                comparison.warnings.push_back(
+                    "Benchmark '" + result.name + "' has a baseline of zero, and cannot be compared.");
+                continue;
+            }
+            entry.change = 100. * ((entry.current - entry.baseline) / entry.baseline);
+            if ((options.test == welch) && (before.size() > 1) && (after.size() > 1)) {
+                entry.result = timelib::welch_t_test(before, after);
+            } else {
+                entry.result = timelib::mann_whitney_u(before, after);
+            }
+            entry.status = unchanged;
+            if (entry.result.p_value < options.alpha) {
+                if (entry.change > options.threshold) {
+                    entry.status = regressed;
+                } else if (entry.change < -options.threshold) {
+                    entry.status = improved;
+                }
+            }
+        }
+        comparison.entries.push_back(entry);
+    }
+    // The benchmarks that disappeared from the current run.
+    for (const auto &reference : baseline.results) {
+        if (current.find(reference.name) == nullptr) {
+            baseline_entry_t entry;
+            entry.name             = reference.name;
+            entry.baseline         = reference.repetitions.empty() ? 0. : timelib::median(reference.samples());
+            entry.current          = 0.;
+            entry.change           = 0.;
+            entry.result.statistic = 0.;
+            entry.result.p_value   = 1.;
+            entry.status           = missing;
+            comparison.entries.push_back(entry);
+            comparison.warnings.push_back("Benchmark '" + reference.name + "' is missing from the current run.");
+        }
+    }
+    return comparison;
+}
+
+} // namespace timelib
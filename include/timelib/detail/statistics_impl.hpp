@@ -0,0 +1,344 @@
+/// @file statistics_impl.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the statistics, the hypothesis tests and the numerical functions behind them.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace timelib
+{
+
+template <typename T>
+auto mean(const std::vector<T> &samples) -> T
+{
+    static_assert(std::is_floating_point<T>::value, "Samples must be floating-point values.");
+    if (samples.empty()) {
+        return T(0);
+    }
+    double sum = 0.;
+    for (const T &sample : samples) {
+        sum += static_cast<double>(sample);
+    }
+    return static_cast<T>(sum / static_cast<double>(samples.size()));
+}
+
+template <typename T>
+auto variance(const std::vector<T> &samples) -> T
+{
+    if (samples.size() < 2) {
+        return T(0);
+    }
+    double average = static_cast<double>(timelib::mean(samples));
+    double sum     = 0.;
+    for (const T &sample : samples) {
+        double delta = static_cast<double>(sample) - average;
+        sum += delta * delta;
+    }
+    return static_cast<T>(sum / static_cast<double>(samples.size() - 1));
+}
+
+template <typename T>
+auto stddev(const std::vector<T> &samples) -> T
+{
+    return std::sqrt(timelib::variance(samples));
+}
+
+template <typename T>
+auto percentile_sorted(const std::vector<T> &sorted, double percentage) -> T
+{
+    if (sorted.empty()) {
+        throw std::invalid_argument("Cannot compute the percentile of an empty set of samples.");
+    }
+    if ((percentage < 0.) || (percentage > 100.)) {
+        throw std::invalid_argument("The percentile must be between 0 and 100.");
+    }
+    double position   = (percentage / 100.) * static_cast<double>(sorted.size() - 1);
+    auto lower        = static_cast<std::size_t>(std::floor(position));
+    std::size_t upper = std::min(lower + 1, sorted.size() - 1);
+    double fraction   = position - static_cast<double>(lower);
+    return static_cast<T>(
+        static_cast<double>(sorted[lower]) +
+        (fraction * (static_cast<double>(sorted[upper]) - static_cast<double>(sorted[lower]))));
+}
+
+template <typename T>
+auto percentile(std::vector<T> samples, double percentage) -> T
+{
+    std::sort(samples.begin(), samples.end());
+    return timelib::percentile_sorted(samples, percentage);
+}
+
+template <typename T>
+auto median(const std::vector<T> &samples) -> T
+{
+    return timelib::percentile(samples, 50.);
+}
+
+template <typename T>
+auto mad(const std::vector<T> &samples) -> T
+{
+    T center = timelib::median(samples);
+    std::vector<T> deviations;
+    deviations.reserve(samples.size());
+    for (const T &sample : samples) {
+        deviations.push_back(std::abs(sample - center));
+    }
+    return timelib::median(deviations);
+}
+
+template <typename T>
+auto bootstrap_mean(const std::vector<T> &samples, const bootstrap_options_t &options) -> confidence_interval_t<T>
+{
+    return timelib::bootstrap(samples, [](const std::vector<T> &values) { return timelib::mean(values); }, options);
+}
+
+template <typename T>
+auto bootstrap_median(const std::vector<T> &samples, const bootstrap_options_t &options) -> confidence_interval_t<T>
+{
+    return timelib::bootstrap(samples, [](const std::vector<T> &values) { return timelib::median(values); }, options);
+}
+
+template <typename T>
+auto tukey_fences(std::vector<T> samples) -> tukey_fences_t<T>
+{
+    std::sort(samples.begin(), samples.end());
+    T q1  = timelib::percentile_sorted(samples, 25.);
+    T q3  = timelib::percentile_sorted(samples, 75.);
+    T iqr = q3 - q1;
+    tukey_fences_t<T> fences;
+    fences.low_severe  = q1 - (T(3) * iqr);
+    fences.low_mild    = q1 - (T(1.5) * iqr);
+    fences.high_mild   = q3 + (T(1.5) * iqr);
+    fences.high_severe = q3 + (T(3) * iqr);
+    return fences;
+}
+
+template <typename T>
+auto classify_outliers(const std::vector<T> &samples) -> outliers_t
+{
+    outliers_t outliers = {0, 0, 0, 0};
+    if (samples.empty()) {
+        return outliers;
+    }
+    tukey_fences_t<T> fences = timelib::tukey_fences(samples);
+    for (const T &sample : samples) {
+        switch (fences.classify(sample)) {
+        case outlier_low_severe:
+            ++outliers.low_severe;
+            break;
+        case outlier_low_mild:
+            ++outliers.low_mild;
+            break;
+        case outlier_high_mild:
+            ++outliers.high_mild;
+            break;
+        case outlier_high_severe:
+            ++outliers.high_severe;
+            break;
+        case outlier_none:
+        default:
+            break;
+        }
+    }
+    return outliers;
+}
+
+template <typename T>
+auto summarize(const std::vector<T> &samples, const bootstrap_options_t &options) -> summary_t<T>
+{
+    if (samples.empty()) {
+        throw std::invalid_argument("Cannot summarize an empty set of samples.");
+    }
+    std::vector<T> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+    summary_t<T> summary;
+    summary.count    = samples.size();
+    summary.min      = sorted.front();
+    summary.max      = sorted.back();
+    summary.stddev   = timelib::stddev(samples);
+    summary.mad      = timelib::mad(samples);
+    summary.p5       = timelib::percentile_sorted(sorted, 5.);
+    summary.p95      = timelib::percentile_sorted(sorted, 95.);
+    summary.mean     = timelib::bootstrap_mean(samples, options);
+    summary.median   = timelib::bootstrap_median(samples, options);
+    summary.outliers = timelib::classify_outliers(samples);
+    return summary;
+}
+
+template <typename T>
+auto mann_whitney_u(const std::vector<T> &a, const std::vector<T> &b) -> test_result_t
+{
+    if (a.empty() || b.empty()) {
+        throw std::invalid_argument("The Mann-Whitney U test requires two non-empty sets of samples.");
+    }
+    // Pool the samples, remembering which set they come from.
+    std::vector<std::pair<T, bool> > pooled;
+    pooled.reserve(a.size() + b.size());
+    for (const T &value : a) {
+        pooled.emplace_back(value, true);
+    }
+    for (const T &value : b) {
+        pooled.emplace_back(value, false);
+    }
+    std::sort(pooled.begin(), pooled.end());
+    // Rank the samples, averaging the ranks of ties.
+    double rank_sum   = 0.;
+    double tie_factor = 0.;
+    for (std::size_t i = 0; i < pooled.size();) {
+        std::size_t j = i;
+        while ((j < pooled.size()) && !(pooled[i].first < pooled[j].first)) {
+            ++j;
+        }
+        double ties = static_cast<double>(j - i);
+        double rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2.;
+        for (std::size_t k = i; k < j; ++k) {
+            if (pooled[k].second) {
+                rank_sum += rank;
+            }
+        }
+        tie_factor += (ties * ties * ties) - ties;
+        i = j;
+    }
+    auto n1         = static_cast<double>(a.size());
+    auto n2         = static_cast<double>(b.size());
+    double n        = n1 + n2;
+    double u        = rank_sum - (n1 * (n1 + 1.) / 2.);
+    double expected = n1 * n2 / 2.;
+    double sigma    = std::sqrt((n1 * n2 / 12.) * ((n + 1.) - (tie_factor / (n * (n - 1.)))));
+    test_result_t result;
+    if (!(sigma > 0.)) {
+        result.statistic = 0.;
+        result.p_value   = 1.;
+        return result;
+    }
+    // Apply the continuity correction towards the expected value.
+    double deviation = u - expected;
+    double corrected = std::max(std::abs(deviation) - 0.5, 0.);
+    result.statistic = ((deviation < 0.) ? -corrected : corrected) / sigma;
+    result.p_value   = std::min(std::erfc(std::abs(result.statistic) / std::sqrt(2.)), 1.);
+    return result;
+}
+
+template <typename T>
+auto welch_t_test(const std::vector<T> &a, const std::vector<T> &b) -> test_result_t
+{
+    if ((a.size() < 2) || (b.size() < 2)) {
+        throw std::invalid_argument("The Welch t-test requires at least two samples in each set.");
+    }
+    auto n1         = static_cast<double>(a.size());
+    auto n2         = static_cast<double>(b.size());
+    double v1       = static_cast<double>(timelib::variance(a)) / n1;
+    double v2       = static_cast<double>(timelib::variance(b)) / n2;
+    double standard = std::sqrt(v1 + v2);
+    test_result_t result;
+    if (!(standard > 0.)) {
+        result.statistic = 0.;
+        result.p_value   = 1.;
+        return result;
+    }
+    result.statistic = (static_cast<double>(timelib::mean(a)) - static_cast<double>(timelib::mean(b))) / standard;
+    double dof       = ((v1 + v2) * (v1 + v2)) / (((v1 * v1) / (n1 - 1.)) + ((v2 * v2) / (n2 - 1.)));
+    double t2        = result.statistic * result.statistic;
+    result.p_value   = detail::incomplete_beta(dof / 2., 0.5, dof / (dof + t2));
+    return result;
+}
+
+template <typename T>
+auto difference_of_means(const std::vector<T> &a, const std::vector<T> &b, double confidence)
+    -> confidence_interval_t<T>
+{
+    confidence_interval_t<T> interval;
+    interval.confidence = confidence;
+    interval.estimate   = timelib::mean(a) - timelib::mean(b);
+    double error        = 0.;
+    if (!a.empty()) {
+        error += static_cast<double>(timelib::variance(a)) / static_cast<double>(a.size());
+    }
+    if (!b.empty()) {
+        error += static_cast<double>(timelib::variance(b)) / static_cast<double>(b.size());
+    }
+    auto half_width = static_cast<T>(detail::normal_quantile(0.5 + (confidence / 2.)) * std::sqrt(error));
+    interval.lower  = interval.estimate - half_width;
+    interval.upper  = interval.estimate + half_width;
+    return interval;
+}
+
+namespace detail
+{
+
+TIMELIB_INLINE auto incomplete_beta_fraction(double a, double b, double x) -> double
+{
+    const double tiny = 1e-300;
+    double c          = 1.;
+    double d          = 1. - ((a + b) * x / (a + 1.));
+    d                 = 1. / ((std::abs(d) < tiny) ? tiny : d);
+    double result     = d;
+    for (int m = 1; m <= 300; ++m) {
+        double dm = static_cast<double>(m);
+        // Even step.
+        double numerator = dm * (b - dm) * x / ((a + (2. * dm) - 1.) * (a + (2. * dm)));
+        d                = 1. + (numerator * d);
+        c                = 1. + (numerator / c);
+        d                = 1. / ((std::abs(d) < tiny) ? tiny : d);
+        c                = (std::abs(c) < tiny) ? tiny : c;
+        result *= d * c;
+        // Odd step.
+        numerator = -(a + dm) * (a + b + dm) * x / ((a + (2. * dm)) * (a + (2. * dm) + 1.));
+        d         = 1. + (numerator * d);
+        c         = 1. + (numerator / c);
+        d         = 1. / ((std::abs(d) < tiny) ? tiny : d);
+        c         = (std::abs(c) < tiny) ? tiny : c;
+        double delta = d * c;
+        result *= delta;
+        if (std::abs(delta - 1.) < 1e-12) {
+            break;
+        }
+    }
+    return result;
+}
+
+TIMELIB_INLINE auto incomplete_beta(double a, double b, double x) -> double
+{
+    if (x <= 0.) {
+        return 0.;
+    }
+    if (x >= 1.) {
+        return 1.;
+    }
+    double front = std::exp(
+        std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + (a * std::log(x)) + (b * std::log(1. - x)));
+    if (x < ((a + 1.) / (a + b + 2.))) {
+        return front * detail::incomplete_beta_fraction(a, b, x) / a;
+    }
+    return 1. - (front * detail::incomplete_beta_fraction(b, a, 1. - x) / b);
+}
+
+TIMELIB_INLINE auto normal_quantile(double probability) -> double
+{
+    double low  = -40.;
+    double high = 40.;
+    for (int i = 0; i < 200; ++i) {
+        double middle = (low + high) / 2.;
+        if ((0.5 * std::erfc(-middle / std::sqrt(2.))) < probability) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return (low + high) / 2.;
+}
+
+} // namespace detail
+
+} // namespace timelib
@@ -10,14 +10,48 @@
 
 #include "timelib/timespec.hpp"
 
-#include <iomanip>
-#include <sstream>
+#include <cstdio>
 #include <string>
 #include <utility>
 
 namespace timelib
 {
 
+namespace detail
+{
+
+/// @brief Formats an amount of seconds, scaling it to the most readable unit.
+/// @param seconds the amount of seconds.
+/// @return the formatted string (e.g., "12.35 ns").
+inline auto format_time(double seconds) -> std::string
+{
+    char buffer[64];
+    double magnitude = (seconds < 0.) ? -seconds : seconds;
+    if (magnitude < 1e-6) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f ns", seconds * 1e9);
+    } else if (magnitude < 1e-3) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f us", seconds * 1e6);
+    } else if (magnitude < 1.) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f ms", seconds * 1e3);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.2f s", seconds);
+    }
+    return buffer;
+}
+
+/// @brief Appends a field of a human readable duration, right-aligned on three characters.
+/// @param output the string receiving the field.
+/// @param value the value of the field.
+/// @param unit the unit of the field.
+inline void append_field(std::string &output, time_t value, char unit)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%3lld%c ", static_cast<long long>(value), unit);
+    output += buffer;
+}
+
+} // namespace detail
+
 /// @brief The way the stopwatch prints the elapsed time.
 enum print_mode_t : unsigned char {
     human,   ///< Human readable     :  1h  4m  2s   1m 153u 399n
@@ -246,9 +280,11 @@ public:
     /// @return A string representing the Duration.
     auto to_string() const -> std::string
     {
-        std::stringstream ss;
+        std::string output;
         if (_print_mode == total) {
-            ss << _duration.to_nanoseconds<double>() * 1e-09;
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%g", _duration.to_nanoseconds<double>() * 1e-09);
+            output = buffer;
         } else {
             time_t h  = 0;
             time_t m  = 0;
@@ -264,46 +300,37 @@ public:
             us        = detail::ns_to_microseconds(ns, &ns);
             if (_print_mode == human) {
                 if (h != 0) {
-                    ss << std::setw(3) << h << "H ";
+                    detail::append_field(output, h, 'H');
                 }
                 if (m != 0) {
-                    ss << std::setw(3) << m << "M ";
+                    detail::append_field(output, m, 'M');
                 }
                 if (s != 0) {
-                    ss << std::setw(3) << s << "s ";
+                    detail::append_field(output, s, 's');
                 }
                 if (ms != 0) {
-                    ss << std::setw(3) << ms << "m ";
+                    detail::append_field(output, ms, 'm');
                 }
                 if (us != 0) {
-                    ss << std::setw(3) << us << "u ";
+                    detail::append_field(output, us, 'u');
                 }
                 if (ns != 0) {
-                    ss << std::setw(3) << ns << "n ";
+                    detail::append_field(output, ns, 'n');
                 }
             } else if (_print_mode == numeric) {
-                ss << h << "." << m << "." << s << "." << ms << "." << us << "." << ns;
+                output = std::to_string(h) + "." + std::to_string(m) + "." + std::to_string(s) + "." +
+                         std::to_string(ms) + "." + std::to_string(us) + "." + std::to_string(ns);
             } else if (!_format.empty()) {
-                std::string output = _format;
+                output = _format;
                 timelib::Duration::replace(output, "%H", std::to_string(h));
                 timelib::Duration::replace(output, "%M", std::to_string(m));
                 timelib::Duration::replace(output, "%s", std::to_string(s));
                 timelib::Duration::replace(output, "%m", std::to_string(ms));
                 timelib::Duration::replace(output, "%u", std::to_string(us));
                 timelib::Duration::replace(output, "%n", std::to_string(ns));
-                ss << output;
             }
         }
-        return ss.str();
-    }
-
-    /// @brief Prints the Duration to an output stream.
-    /// @param lhs The output stream.
-    /// @param rhs The Duration to print.
-    /// @return The modified output stream.
-    friend auto operator<<(std::ostream &lhs, const Duration &rhs) -> std::ostream &
-    {
-        return (lhs << rhs.to_string());
+        return output;
     }
 
 private:
@@ -0,0 +1,212 @@
+/// @file histogram.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines a log-linear histogram of durations, with bounded relative error on its percentiles.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/duration.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace timelib
+{
+
+/// @brief A histogram of durations, whose buckets grow geometrically, so
+/// that the relative error of a percentile is bounded by the precision.
+/// @details Recording a value costs a logarithm and an increment, and the
+/// memory does not depend on the number of values, so millions of latencies
+/// can be recorded. Values outside the range fall in the first or last bucket.
+class Histogram
+{
+public:
+    /// @brief Constructs a Histogram.
+    /// @param lowest the lowest value that can be told apart from zero, in seconds.
+    /// @param highest the highest value that can be told apart from infinity, in seconds.
+    /// @param precision the relative width of a bucket (e.g., 0.01 for 1%).
+    /// @throw std::invalid_argument if the range or the precision are not valid.
+    explicit Histogram(double lowest = 1e-9, double highest = 100., double precision = 0.01)
+        : _lowest(lowest)
+        , _growth(std::log1p(precision))
+        , _counts()
+        , _count(0)
+        , _sum(0.)
+        , _min(std::numeric_limits<double>::max())
+        , _max(0.)
+    {
+        if ((lowest <= 0.) || (highest <= lowest)) {
+            throw std::invalid_argument("A histogram needs a range with 0 < lowest < highest.");
+        }
+        if (precision <= 0.) {
+            throw std::invalid_argument("A histogram needs a positive precision.");
+        }
+        _counts.resize(this->bucket(highest) + 1, 0);
+    }
+
+    /// @brief Records a value.
+    /// @param value the value, in seconds.
+    /// @param count the number of times the value has been observed.
+    void record(double value, std::uint64_t count = 1)
+    {
+        _counts[this->bucket(value)] += count;
+        _count += count;
+        _sum += value * static_cast<double>(count);
+        _min = std::min(_min, value);
+        _max = std::max(_max, value);
+    }
+
+    /// @brief Adds the values of another histogram, with the same range and precision.
+    /// @param other the other histogram.
+    /// @throw std::invalid_argument if the histograms have different buckets.
+    void merge(const Histogram &other)
+    {
+        if (_counts.size() != other._counts.size()) {
+            throw std::invalid_argument("Only histograms with the same buckets can be merged.");
+        }
+        for (std::size_t i = 0; i < _counts.size(); ++i) {
+            _counts[i] += other._counts[i];
+        }
+        _count += other._count;
+        _sum += other._sum;
+        _min = std::min(_min, other._min);
+        _max = std::max(_max, other._max);
+    }
+
+    /// @brief Removes all the values.
+    void reset()
+    {
+        std::fill(_counts.begin(), _counts.end(), 0);
+        _count = 0;
+        _sum   = 0.;
+        _min   = std::numeric_limits<double>::max();
+        _max   = 0.;
+    }
+
+    /// @brief Returns the number of recorded values.
+    /// @return the number of values.
+    auto count() const -> std::uint64_t { return _count; }
+
+    /// @brief Returns the mean of the recorded values.
+    /// @return the mean, in seconds.
+    auto mean() const -> double { return (_count > 0) ? (_sum / static_cast<double>(_count)) : 0.; }
+
+    /// @brief Returns the smallest recorded value.
+    /// @return the minimum, in seconds.
+    auto min() const -> double { return (_count > 0) ? _min : 0.; }
+
+    /// @brief Returns the largest recorded value.
+    /// @return the maximum, in seconds.
+    auto max() const -> double { return _max; }
+
+    /// @brief Returns the value below which the given percentage of values fall.
+    /// @param percent the percentile, between 0 and 100.
+    /// @return the percentile, in seconds, with the relative error of the precision.
+    auto percentile(double percent) const -> double
+    {
+        if (_count == 0) {
+            return 0.;
+        }
+        percent            = std::min(std::max(percent, 0.), 100.);
+        auto rank          = static_cast<std::uint64_t>(std::ceil((percent / 100.) * static_cast<double>(_count)));
+        rank               = std::max<std::uint64_t>(rank, 1);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < _counts.size(); ++i) {
+            seen += _counts[i];
+            if (seen >= rank) {
+                // The geometric middle of the bucket, within the observed range.
+                return std::min(std::max(this->value(i, 0.5), _min), _max);
+            }
+        }
+        return _max;
+    }
+
+    /// @brief Returns the non-empty buckets.
+    /// @return the lower bound (in seconds) and the count of each non-empty bucket.
+    auto buckets() const -> std::vector<std::pair<double, std::uint64_t>>
+    {
+        std::vector<std::pair<double, std::uint64_t>> result;
+        for (std::size_t i = 0; i < _counts.size(); ++i) {
+            if (_counts[i] > 0) {
+                result.emplace_back(this->value(i, 0.), _counts[i]);
+            }
+        }
+        return result;
+    }
+
+    /// @brief Converts the histogram to a line of percentiles.
+    /// @return the string representation of the histogram.
+    auto to_string() const -> std::string
+    {
+        std::stringstream ss;
+        ss << "n=" << _count << " mean=" << detail::format_time(this->mean())
+           << " p50=" << detail::format_time(this->percentile(50.))
+           << " p90=" << detail::format_time(this->percentile(90.))
+           << " p99=" << detail::format_time(this->percentile(99.))
+           << " p99.9=" << detail::format_time(this->percentile(99.9))
+           << " max=" << detail::format_time(this->max());
+        return ss.str();
+    }
+
+    /// @brief Prints the histogram to an output stream.
+    /// @param lhs The output stream.
+    /// @param rhs The histogram to print.
+    /// @return The modified output stream.
+    friend auto operator<<(std::ostream &lhs, const Histogram &rhs) -> std::ostream &
+    {
+        return (lhs << rhs.to_string());
+    }
+
+private:
+    /// @brief Returns the bucket of a value.
+    /// @param value the value, in seconds.
+    /// @return the index of the bucket.
+    auto bucket(double value) const -> std::size_t
+    {
+        if (value <= _lowest) {
+            return 0;
+        }
+        auto index = static_cast<std::size_t>(std::log(value / _lowest) / _growth) + 1;
+        return _counts.empty() ? index : std::min(index, _counts.size() - 1);
+    }
+
+    /// @brief Returns a value inside a bucket.
+    /// @param index the index of the bucket.
+    /// @param offset the position inside the bucket, from 0 (lower bound) to 1 (upper bound).
+    /// @return the value, in seconds.
+    auto value(std::size_t index, double offset) const -> double
+    {
+        if (index == 0) {
+            return _lowest * offset;
+        }
+        return _lowest * std::exp((static_cast<double>(index - 1) + offset) * _growth);
+    }
+
+    /// @brief The lowest value that can be told apart from zero.
+    double _lowest;
+    /// @brief The logarithm of the ratio between consecutive buckets.
+    double _growth;
+    /// @brief The number of values in each bucket.
+    std::vector<std::uint64_t> _counts;
+    /// @brief The number of values.
+    std::uint64_t _count;
+    /// @brief The sum of the values.
+    double _sum;
+    /// @brief The smallest value.
+    double _min;
+    /// @brief The largest value.
+    double _max;
+};
+
+} // namespace timelib
@@ -0,0 +1,231 @@
+/// @file history.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the history of benchmark results, with change-point detection and trend charts.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/config.hpp"
+#include "timelib/report.hpp"
+
+#include <string>
+#include <vector>
+
+namespace timelib
+{
+
+/// @brief The summary of a benchmark in a run of the history.
+struct history_point_t {
+    /// @brief The name of the benchmark.
+    std::string name;
+    /// @brief The median time per iteration, in seconds.
+    double median;
+    /// @brief The mean time per iteration, in seconds.
+    double mean;
+    /// @brief The fastest repetition, in seconds.
+    double min;
+    /// @brief The first quartile of the repetitions, in seconds.
+    double p25;
+    /// @brief The third quartile of the repetitions, in seconds.
+    double p75;
+    /// @brief The slowest repetition, in seconds.
+    double max;
+    /// @brief The number of repetitions.
+    std::size_t repetitions;
+};
+
+/// @brief A run of the benchmarks, as stored in the history.
+struct TIMELIB_API history_run_t {
+    /// @brief The date of the run.
+    std::string date;
+    /// @brief A label of the run (e.g., the commit), possibly empty.
+    std::string label;
+    /// @brief The environment of the run.
+    environment_t environment;
+    /// @brief The summary of each benchmark.
+    std::vector<history_point_t> points;
+
+    /// @brief Looks for a benchmark.
+    /// @param name the name of the benchmark.
+    /// @return a pointer to its summary, or nullptr if the run does not contain it.
+    auto find(const std::string &name) const -> const history_point_t *
+    {
+        for (const auto &point : points) {
+            if (point.name == name) {
+                return &point;
+            }
+        }
+        return nullptr;
+    }
+
+    /// @brief Summarizes a report.
+    /// @param report the report.
+    /// @param label the label of the run.
+    /// @return the run.
+    static auto from_report(const report_t &report, const std::string &label = std::string()) -> history_run_t;
+
+    /// @brief Converts the run to a single line of JSON.
+    /// @return the JSON text, without the line break.
+    auto to_json() const -> std::string;
+
+    /// @brief Parses a line of the history.
+    /// @param text the JSON text.
+    /// @return the run.
+    /// @throw std::runtime_error if the text is not a valid run.
+    static auto from_json(const std::string &text) -> history_run_t;
+};
+
+/// @brief Appends a run to a history file, with a line of JSON per run.
+/// @details The file is only ever appended to, so that concurrent or
+/// interrupted runs cannot corrupt the previous ones.
+/// @param path the path of the history file.
+/// @param run the run.
+/// @throw std::runtime_error if the file cannot be written.
+TIMELIB_INLINE void append_history(const std::string &path, const history_run_t &run);
+
+/// @brief Loads a history file.
+/// @param path the path of the history file.
+/// @return the runs, in the order they were appended.
+/// @throw std::runtime_error if the file cannot be read, or a line is not a valid run.
+TIMELIB_INLINE auto load_history(const std::string &path) -> std::vector<history_run_t>;
+
+/// @brief The options of the change-point detection.
+struct change_point_options_t {
+    /// @brief Constructs the default options.
+    change_point_options_t()
+        : threshold(5.)
+        , alpha(0.001)
+        , min_segment(3)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief The smallest change of the mean worth reporting, in percent.
+    double threshold;
+    /// @brief The significance level of the Welch t-test between the two sides.
+    double alpha;
+    /// @brief The smallest number of runs on each side of a change point.
+    std::size_t min_segment;
+};
+
+/// @brief A point of a series where the mean changes.
+struct change_point_t {
+    /// @brief The index of the first value after the change.
+    std::size_t index;
+    /// @brief The mean of the segment before the change.
+    double before;
+    /// @brief The mean of the segment after the change.
+    double after;
+    /// @brief The relative change of the mean, in percent (positive when the values grow).
+    double change;
+    /// @brief The p-value of the Welch t-test between the two segments.
+    double p_value;
+};
+
+namespace detail
+{
+
+/// @brief Looks for change points in a segment of a series, by binary segmentation.
+/// @param values the series.
+/// @param begin the first index of the segment.
+/// @param end one past the last index of the segment.
+/// @param options the options of the detection.
+/// @param result the change points found so far.
+TIMELIB_INLINE void segment_series(
+    const std::vector<double> &values,
+    std::size_t begin,
+    std::size_t end,
+    const change_point_options_t &options,
+    std::vector<change_point_t> &result);
+
+} // namespace detail
+
+/// @brief Finds the points where the mean of a series changes.
+/// @details Binary segmentation: the series is split where the Welch t
+/// statistic between the two sides is the largest, if the split is both
+/// significant and larger than the threshold, and then each side is split
+/// in turn.
+/// @param values the series, in chronological order.
+/// @param options the options of the detection.
+/// @return the change points, in chronological order.
+TIMELIB_INLINE auto detect_change_points(
+    const std::vector<double> &values,
+    const change_point_options_t &options = change_point_options_t()) -> std::vector<change_point_t>;
+
+/// @brief The history of a single benchmark.
+struct TIMELIB_API history_series_t {
+    /// @brief The name of the benchmark.
+    std::string name;
+    /// @brief The label of each run containing the benchmark (the date, if the label is empty).
+    std::vector<std::string> labels;
+    /// @brief The summary of the benchmark in each run.
+    std::vector<history_point_t> points;
+    /// @brief The change points of the medians.
+    std::vector<change_point_t> change_points;
+
+    /// @brief Returns the median of each run.
+    /// @return the medians, in seconds.
+    auto medians() const -> std::vector<double>
+    {
+        std::vector<double> result;
+        for (const auto &point : points) {
+            result.push_back(point.median);
+        }
+        return result;
+    }
+
+    /// @brief Draws the series as a chart for the terminal.
+    /// @details Each column is a run: '*' marks the median, ':' the range
+    /// between the quartiles, and '^' below the axis marks a change point.
+    /// Only the last runs are drawn, if they do not fit in the width.
+    /// @param width the maximum number of runs drawn, at least one.
+    /// @param height the number of rows of the chart, nothing is drawn below two.
+    /// @return the chart.
+    auto to_ascii(std::size_t width = 60, std::size_t height = 10) const -> std::string;
+};
+
+/// @brief Returns the names of the benchmarks of a history.
+/// @param runs the runs of the history.
+/// @return the names, in order of first appearance.
+TIMELIB_INLINE auto history_names(const std::vector<history_run_t> &runs) -> std::vector<std::string>;
+
+/// @brief Extracts the series of a benchmark from a history, and detects its change points.
+/// @param runs the runs of the history.
+/// @param name the name of the benchmark.
+/// @param options the options of the change-point detection.
+/// @return the series.
+TIMELIB_INLINE auto history_series(
+    const std::vector<history_run_t> &runs,
+    const std::string &name,
+    const change_point_options_t &options = change_point_options_t()) -> history_series_t;
+
+namespace detail
+{
+
+/// @brief Escapes a text for HTML.
+/// @param text the text.
+/// @return the escaped text.
+TIMELIB_INLINE auto html_escape(const std::string &text) -> std::string;
+
+} // namespace detail
+
+/// @brief Renders the series as a self-contained HTML page, with an SVG chart for each benchmark.
+/// @details Each chart shows the range between the quartiles of each run
+/// as a bar, the range between its fastest and slowest repetitions as a
+/// whisker, the medians as a line, and the change points as dashed red
+/// lines, followed by a table of the change points.
+/// @param series the series to render.
+/// @param title the title of the page.
+/// @return the HTML text.
+TIMELIB_INLINE auto render_history_html(
+    const std::vector<history_series_t> &series,
+    const std::string &title = "timelib history") -> std::string;
+
+} // namespace timelib
+
+#if !defined(TIMELIB_COMPILED_LIB)
+#include "timelib/detail/history_impl.hpp"
+#endif
@@ -0,0 +1,338 @@
+/// @file instrument.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines instrumentation macros (scoped timers, zones and counters), removed at compile time by level.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/config.hpp"
+#include "timelib/duration.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// @brief No instrumentation.
+#define TIMELIB_LEVEL_OFF 0
+/// @brief The instrumentation of the coarse phases (e.g., loading, solving, saving).
+#define TIMELIB_LEVEL_COARSE 1
+/// @brief The instrumentation of the functions inside the phases.
+#define TIMELIB_LEVEL_FINE 2
+/// @brief The instrumentation of the inner loops, too costly to leave on.
+#define TIMELIB_LEVEL_VERBOSE 3
+
+#if !defined(TIMELIB_LEVEL)
+/// @brief The highest level of instrumentation compiled in, set by the build
+/// system (the TIMELIB_LEVEL option of CMake). The instrumentation macros of
+/// a higher level expand to nothing.
+#define TIMELIB_LEVEL TIMELIB_LEVEL_OFF
+#endif
+
+#if (TIMELIB_LEVEL < TIMELIB_LEVEL_OFF) || (TIMELIB_LEVEL > TIMELIB_LEVEL_VERBOSE)
+#error "TIMELIB_LEVEL must be between 0 (off) and 3 (verbose)."
+#endif
+
+// Each level is mapped to 1 when it is compiled in, and to 0 otherwise, and
+// the instrumentation macros paste it to their name, selecting either the
+// definition that measures or the one that expands to nothing.
+
+#if TIMELIB_LEVEL >= TIMELIB_LEVEL_COARSE
+#define TIMELIB_LEVEL_ENABLED_1 1
+#else
+#define TIMELIB_LEVEL_ENABLED_1 0
+#endif
+#if TIMELIB_LEVEL >= TIMELIB_LEVEL_FINE
+#define TIMELIB_LEVEL_ENABLED_2 1
+#else
+#define TIMELIB_LEVEL_ENABLED_2 0
+#endif
+#if TIMELIB_LEVEL >= TIMELIB_LEVEL_VERBOSE
+#define TIMELIB_LEVEL_ENABLED_3 1
+#else
+#define TIMELIB_LEVEL_ENABLED_3 0
+#endif
+
+/// @brief Times the rest of the enclosing scope, and adds it to the timer with the given name.
+/// @details Usage:
+///     TIMELIB_SCOPED_TIMER(TIMELIB_LEVEL_COARSE, "load");
+/// Expands to nothing if the level is above TIMELIB_LEVEL. A single
+/// instrumentation macro can be used per line.
+#define TIMELIB_SCOPED_TIMER(level, name)                                                                              \
+    TIMELIB_CONCAT(TIMELIB_SCOPED_TIMER_, TIMELIB_CONCAT(TIMELIB_LEVEL_ENABLED_, level))(name)
+
+/// @brief Times the rest of the enclosing scope, and adds it to the timer named after the enclosing function.
+/// @details Usage:
+///     TIMELIB_ZONE(TIMELIB_LEVEL_FINE);
+/// Expands to nothing if the level is above TIMELIB_LEVEL.
+#define TIMELIB_ZONE(level)                                                                                            \
+    TIMELIB_CONCAT(TIMELIB_SCOPED_TIMER_, TIMELIB_CONCAT(TIMELIB_LEVEL_ENABLED_, level))(__func__)
+
+/// @brief Adds a value to the counter with the given name.
+/// @details Usage:
+///     TIMELIB_COUNTER(TIMELIB_LEVEL_VERBOSE, "cache misses", misses);
+/// Expands to nothing if the level is above TIMELIB_LEVEL, in which case the
+/// value is not evaluated.
+#define TIMELIB_COUNTER(level, name, value)                                                                            \
+    TIMELIB_CONCAT(TIMELIB_COUNTER_, TIMELIB_CONCAT(TIMELIB_LEVEL_ENABLED_, level))(name, value)
+
+/// @brief The scoped timer of a level that is compiled in.
+#define TIMELIB_SCOPED_TIMER_1(name)                                                                                   \
+    static timelib::Probe &TIMELIB_CONCAT(timelib_probe_, __LINE__) = timelib::register_probe(name, timelib::timed);   \
+    const timelib::ScopedProbe TIMELIB_CONCAT(timelib_scope_, __LINE__)(TIMELIB_CONCAT(timelib_probe_, __LINE__))
+
+/// @brief The scoped timer of a level that is compiled out.
+#define TIMELIB_SCOPED_TIMER_0(name)
+
+/// @brief The counter of a level that is compiled in.
+#define TIMELIB_COUNTER_1(name, value)                                                                                 \
+    do {                                                                                                               \
+        static timelib::Probe &timelib_probe = timelib::register_probe(name, timelib::counted);                       \
+        timelib_probe.add(static_cast<std::uint64_t>(value));                                                          \
+    } while (false)
+
+/// @brief The counter of a level that is compiled out.
+#define TIMELIB_COUNTER_0(name, value)
+
+namespace timelib
+{
+
+/// @brief What a probe measures.
+enum probe_kind_t : unsigned char {
+    timed,  ///< Durations, in nanoseconds, added by the scoped timers and the zones.
+    counted ///< Values added by the counters.
+};
+
+/// @brief The totals of an instrumentation point, updated atomically so that
+/// it can be shared by all the threads running through the point.
+class Probe
+{
+public:
+    /// @brief Constructs a Probe.
+    /// @param name the name of the probe.
+    /// @param kind what the probe measures.
+    Probe(std::string name, probe_kind_t kind)
+        : _name(std::move(name))
+        , _kind(kind)
+        , _count(0)
+        , _total(0)
+        , _min(std::numeric_limits<std::uint64_t>::max())
+        , _max(0)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Adds a value.
+    /// @param value the value (nanoseconds, for the timers).
+    void add(std::uint64_t value)
+    {
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _total.fetch_add(value, std::memory_order_relaxed);
+        std::uint64_t current = _min.load(std::memory_order_relaxed);
+        while ((value < current) && !_min.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+        current = _max.load(std::memory_order_relaxed);
+        while ((value > current) && !_max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /// @brief Clears the values added so far.
+    void reset()
+    {
+        _count.store(0, std::memory_order_relaxed);
+        _total.store(0, std::memory_order_relaxed);
+        _min.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+        _max.store(0, std::memory_order_relaxed);
+    }
+
+    /// @brief Returns the name of the probe.
+    /// @return the name.
+    auto name() const -> const std::string & { return _name; }
+
+    /// @brief Returns what the probe measures.
+    /// @return the kind of the probe.
+    auto kind() const -> probe_kind_t { return _kind; }
+
+    /// @brief Returns the number of values added.
+    /// @return the count.
+    auto count() const -> std::uint64_t { return _count.load(std::memory_order_relaxed); }
+
+    /// @brief Returns the sum of the values added.
+    /// @return the total.
+    auto total() const -> std::uint64_t { return _total.load(std::memory_order_relaxed); }
+
+    /// @brief Returns the smallest value added.
+    /// @return the minimum, zero if no value has been added.
+    auto min() const -> std::uint64_t { return (this->count() > 0) ? _min.load(std::memory_order_relaxed) : 0; }
+
+    /// @brief Returns the largest value added.
+    /// @return the maximum.
+    auto max() const -> std::uint64_t { return _max.load(std::memory_order_relaxed); }
+
+    /// @brief Formats the totals of the probe as a row of probes_to_string().
+    /// @return the row, without the line break.
+    auto to_string() const -> std::string
+    {
+        std::uint64_t count = this->count();
+        double mean         = (count > 0) ? static_cast<double>(this->total()) / static_cast<double>(count) : 0.;
+        char buffer[256];
+        if (_kind == timed) {
+            std::string total_time = detail::format_time(static_cast<double>(this->total()) * 1e-9);
+            std::string mean_time  = detail::format_time(mean * 1e-9);
+            std::string min_time   = detail::format_time(static_cast<double>(this->min()) * 1e-9);
+            std::string max_time   = detail::format_time(static_cast<double>(this->max()) * 1e-9);
+            std::snprintf(
+                buffer, sizeof(buffer), "%-32s %12llu %12s %12s %12s %12s", _name.c_str(),
+                static_cast<unsigned long long>(count), total_time.c_str(), mean_time.c_str(), min_time.c_str(),
+                max_time.c_str());
+        } else {
+            std::snprintf(
+                buffer, sizeof(buffer), "%-32s %12llu %12llu %12.2f %12llu %12llu", _name.c_str(),
+                static_cast<unsigned long long>(count), static_cast<unsigned long long>(this->total()), mean,
+                static_cast<unsigned long long>(this->min()), static_cast<unsigned long long>(this->max()));
+        }
+        return buffer;
+    }
+
+private:
+    /// @brief The name of the probe.
+    std::string _name;
+    /// @brief What the probe measures.
+    probe_kind_t _kind;
+    /// @brief The number of values added.
+    std::atomic<std::uint64_t> _count;
+    /// @brief The sum of the values added.
+    std::atomic<std::uint64_t> _total;
+    /// @brief The smallest value added.
+    std::atomic<std::uint64_t> _min;
+    /// @brief The largest value added.
+    std::atomic<std::uint64_t> _max;
+};
+
+/// @brief Adds the time spent in a scope to a probe, when it goes out of scope.
+class ScopedProbe
+{
+public:
+    /// @brief Starts timing the scope.
+    /// @param probe the probe receiving the time.
+    explicit ScopedProbe(Probe &probe)
+        : _probe(probe)
+        , _start(timespec_t::now())
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Copy constructor, deleted, since the scope can be timed only once.
+    /// @param other The other entity to copy.
+    ScopedProbe(const ScopedProbe &other) = delete;
+
+    /// @brief Copy assignment operator, deleted, since the scope can be timed only once.
+    /// @param other The other entity to copy.
+    /// @return A reference to this object.
+    auto operator=(const ScopedProbe &other) -> ScopedProbe & = delete;
+
+    /// @brief Adds the time spent since the construction to the probe.
+    ~ScopedProbe()
+    {
+        timespec_t stop = timespec_t::now();
+        // Integer nanoseconds, instead of the floating-point difference of timespec_t.
+        long long elapsed = (static_cast<long long>(stop.tv_sec - _start.tv_sec) * 1000000000LL) +
+                            static_cast<long long>(stop.tv_nsec - _start.tv_nsec);
+        _probe.add((elapsed > 0) ? static_cast<std::uint64_t>(elapsed) : 0);
+    }
+
+private:
+    /// @brief The probe receiving the time.
+    Probe &_probe;
+    /// @brief When the scope was entered.
+    timespec_t _start;
+};
+
+namespace detail
+{
+
+/// @brief Returns the probes registered by the instrumentation macros.
+/// @details The probes are never destroyed before the end of the program,
+/// so that the references kept by the call sites stay valid.
+/// @return a reference to the probes.
+inline auto probes() -> std::vector<std::unique_ptr<Probe> > &
+{
+    static std::vector<std::unique_ptr<Probe> > result;
+    return result;
+}
+
+/// @brief Returns the mutex protecting the list of probes.
+/// @return a reference to the mutex.
+inline auto probes_mutex() -> std::mutex &
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+} // namespace detail
+
+/// @brief Returns the probe with the given name and kind, registering it on first use.
+/// @details The call sites sharing a name share the probe, and keep a
+/// reference to it in a static variable, so that the registration (and its
+/// lock) happens only once per call site.
+/// @param name the name of the probe.
+/// @param kind what the probe measures.
+/// @return a reference to the probe.
+inline auto register_probe(const std::string &name, probe_kind_t kind) -> Probe &
+{
+    std::lock_guard<std::mutex> lock(detail::probes_mutex());
+    for (const auto &probe : detail::probes()) {
+        if ((probe->name() == name) && (probe->kind() == kind)) {
+            return *probe;
+        }
+    }
+    detail::probes().emplace_back(new Probe(name, kind));
+    return *detail::probes().back();
+}
+
+/// @brief Clears the values of all the probes, keeping them registered.
+inline void reset_probes()
+{
+    std::lock_guard<std::mutex> lock(detail::probes_mutex());
+    for (const auto &probe : detail::probes()) {
+        probe->reset();
+    }
+}
+
+/// @brief Formats the totals of all the probes, the timers first.
+/// @return a table with the count, total, mean, minimum and maximum of each
+/// probe, or an empty string if no probe has been registered (e.g., when
+/// the instrumentation is compiled out).
+inline auto probes_to_string() -> std::string
+{
+    std::lock_guard<std::mutex> lock(detail::probes_mutex());
+    std::string result;
+    const probe_kind_t kinds[] = {timed, counted};
+    for (probe_kind_t kind : kinds) {
+        std::string rows;
+        for (const auto &probe : detail::probes()) {
+            if (probe->kind() == kind) {
+                rows += probe->to_string() + "\n";
+            }
+        }
+        if (rows.empty()) {
+            continue;
+        }
+        char header[256];
+        std::snprintf(
+            header, sizeof(header), "%-32s %12s %12s %12s %12s %12s\n", (kind == timed) ? "Timer" : "Counter", "Count",
+            "Total", "Mean", "Min", "Max");
+        result += (result.empty() ? "" : "\n") + std::string(header) + rows;
+    }
+    return result;
+}
+
+} // namespace timelib
@@ -0,0 +1,55 @@
+/// @file io.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the stream operators of the core classes.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/stopwatch.hpp"
+#include "timelib/timer.hpp"
+
+#include <ostream>
+
+namespace timelib
+{
+
+/// @brief Output stream operator to print timespec_t.
+/// @param os The output stream.
+/// @param ts The timespec_t instance.
+/// @return Reference to the output stream.
+inline auto operator<<(std::ostream &os, const timespec_t &ts) -> std::ostream &
+{
+    os << "<s: " << ts.tv_sec << ", ns: " << ts.tv_nsec << ">";
+    return os;
+}
+
+/// @brief Prints the Duration to an output stream.
+/// @param lhs The output stream.
+/// @param rhs The Duration to print.
+/// @return The modified output stream.
+inline auto operator<<(std::ostream &lhs, const Duration &rhs) -> std::ostream & { return (lhs << rhs.to_string()); }
+
+/// @brief Prints the Timer's total duration to an output stream.
+/// @param lhs The output stream.
+/// @param rhs The Timer to print.
+/// @return The modified output stream.
+inline auto operator<<(std::ostream &lhs, const Timer &rhs) -> std::ostream &
+{
+    lhs << rhs.elapsed().to_string();
+    return lhs;
+}
+
+/// @brief Prints the Stopwatch's total duration to an output stream.
+/// @param lhs The output stream.
+/// @param rhs The Stopwatch to print.
+/// @return The modified output stream.
+inline auto operator<<(std::ostream &lhs, const Stopwatch &rhs) -> std::ostream &
+{
+    lhs << rhs.to_string();
+    return lhs;
+}
+
+} // namespace timelib
@@ -0,0 +1,281 @@
+/// @file isolation.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines CPU affinity, scheduling priority and memory locking helpers, to make timing runs reproducible.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+namespace timelib
+{
+
+/// @brief Pins the calling thread to a processor.
+/// @param cpu the index of the processor.
+/// @return true if the thread has been pinned, false if pinning is not supported or not permitted.
+inline auto pin_current_thread(std::size_t cpu) -> bool
+{
+#if defined(__linux__)
+    if (cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+/// @brief Moves the calling thread to the real-time FIFO scheduling policy.
+/// @details This usually requires root privileges, or the CAP_SYS_NICE
+/// capability. A thread under SCHED_FIFO is not preempted by normal threads,
+/// so the measured function must not spin forever.
+/// @param priority the real-time priority, clamped to the range supported by the system.
+/// @return true if the policy has been changed, false if it is not supported or not permitted.
+inline auto set_realtime_priority(int priority = 50) -> bool
+{
+#if defined(__linux__)
+    struct sched_param param = {};
+    int lowest               = sched_get_priority_min(SCHED_FIFO);
+    int highest              = sched_get_priority_max(SCHED_FIFO);
+    param.sched_priority     = (priority < lowest) ? lowest : ((priority > highest) ? highest : priority);
+    return sched_setscheduler(0, SCHED_FIFO, &param) == 0;
+#else
+    (void)priority;
+    return false;
+#endif
+}
+
+/// @brief Locks all the current and future pages of the process in memory,
+/// so that the measurements are not disturbed by page faults.
+/// @return true if the memory has been locked, false if it is not supported or not permitted.
+inline auto lock_memory() -> bool
+{
+#if defined(__linux__)
+    return mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+#else
+    return false;
+#endif
+}
+
+/// @brief Unlocks the pages locked by lock_memory().
+inline void unlock_memory()
+{
+#if defined(__linux__)
+    (void)munlockall();
+#endif
+}
+
+/// @brief Reads the frequency governor of each processor from sysfs.
+/// @return the governor of each processor, empty if they cannot be read.
+inline auto cpu_governors() -> std::vector<std::string>
+{
+    std::vector<std::string> governors;
+#if defined(__linux__)
+    for (std::size_t cpu = 0;; ++cpu) {
+        std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_governor");
+        std::string governor;
+        if (!file || !(file >> governor)) {
+            break;
+        }
+        governors.push_back(governor);
+    }
+#endif
+    return governors;
+}
+
+namespace detail
+{
+
+/// @brief Formats a sorted list of processors, collapsing the consecutive ones (e.g., "0-3,6,8-9").
+/// @param cpus the processors, in increasing order.
+/// @return the list.
+inline auto format_cpu_list(const std::vector<std::size_t> &cpus) -> std::string
+{
+    std::string result;
+    for (std::size_t i = 0; i < cpus.size();) {
+        std::size_t j = i;
+        while (((j + 1) < cpus.size()) && (cpus[j + 1] == (cpus[j] + 1))) {
+            ++j;
+        }
+        result += (result.empty() ? "" : ",") + std::to_string(cpus[i]);
+        if (j > i) {
+            result += "-" + std::to_string(cpus[j]);
+        }
+        i = j + 1;
+    }
+    return result;
+}
+
+} // namespace detail
+
+/// @brief Checks that every processor runs with the "performance" frequency governor.
+/// @return a single warning listing the processors with a different governor,
+/// grouped by governor, or no warning if they all use "performance".
+inline auto check_cpu_governors() -> std::vector<std::string>
+{
+    std::vector<std::string> governors = cpu_governors();
+    // The other governors, in order of first appearance, with their processors.
+    std::vector<std::pair<std::string, std::vector<std::size_t> > > others;
+    for (std::size_t cpu = 0; cpu < governors.size(); ++cpu) {
+        if (governors[cpu] == "performance") {
+            continue;
+        }
+        std::size_t i = 0;
+        while ((i < others.size()) && (others[i].first != governors[cpu])) {
+            ++i;
+        }
+        if (i == others.size()) {
+            others.emplace_back(governors[cpu], std::vector<std::size_t>());
+        }
+        others[i].second.push_back(cpu);
+    }
+    std::vector<std::string> warnings;
+    if (!others.empty()) {
+        std::string list;
+        for (const auto &other : others) {
+            list += (list.empty() ? "'" : ", '") + other.first + "' on CPUs " + detail::format_cpu_list(other.second);
+        }
+        warnings.push_back(
+            "Frequency governor " + list + " instead of 'performance', timings may vary with the frequency scaling.");
+    }
+    return warnings;
+}
+
+/// @brief The options used to isolate a timing run from the rest of the system.
+struct isolation_options_t {
+    /// @brief Constructs the default options, which change nothing but the governor check.
+    isolation_options_t()
+        : pin(false)
+        , cpu(0)
+        , realtime(false)
+        , priority(50)
+        , lock_memory(false)
+        , check_governor(true)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Pins the measuring thread to the processor `cpu`.
+    bool pin;
+    /// @brief The processor used when pinning.
+    std::size_t cpu;
+    /// @brief Moves the measuring thread to the SCHED_FIFO policy, when permitted.
+    bool realtime;
+    /// @brief The real-time priority used with `realtime`.
+    int priority;
+    /// @brief Locks the memory of the process with mlockall.
+    bool lock_memory;
+    /// @brief Warns when a processor does not use the "performance" governor.
+    bool check_governor;
+};
+
+/// @brief Applies the isolation options to the calling thread, and restores
+/// the previous affinity, scheduling policy and memory locking on destruction.
+class ScopedIsolation
+{
+public:
+    /// @brief Applies the isolation options.
+    /// @details Failures are not errors: they are reported by warnings(), so
+    /// that the same code runs with and without the required privileges.
+    /// @param options the isolation options.
+    explicit ScopedIsolation(const isolation_options_t &options)
+        : _warnings()
+        , _pinned(false)
+        , _realtime(false)
+        , _locked(false)
+    {
+#if defined(__linux__)
+        if (options.pin) {
+            _pinned = (sched_getaffinity(0, sizeof(_affinity), &_affinity) == 0);
+            if (_pinned && !pin_current_thread(options.cpu)) {
+                _pinned = false;
+                _warnings.push_back("Cannot pin the thread to CPU " + std::to_string(options.cpu) + ".");
+            }
+        }
+        if (options.realtime) {
+            _policy   = sched_getscheduler(0);
+            _realtime = (_policy >= 0) && (sched_getparam(0, &_param) == 0);
+            if (_realtime && !set_realtime_priority(options.priority)) {
+                _realtime = false;
+                _warnings.push_back("Cannot switch to SCHED_FIFO (missing privileges?).");
+            }
+        }
+#else
+        if (options.pin || options.realtime) {
+            _warnings.push_back("Thread affinity and priority are not supported on this platform.");
+        }
+#endif
+        if (options.lock_memory) {
+            _locked = lock_memory();
+            if (!_locked) {
+                _warnings.push_back("Cannot lock the memory (missing privileges, or RLIMIT_MEMLOCK too low?).");
+            }
+        }
+        if (options.check_governor) {
+            std::vector<std::string> governors = check_cpu_governors();
+            _warnings.insert(_warnings.end(), governors.begin(), governors.end());
+        }
+    }
+
+    /// @brief Restores the previous state of the thread and of the process.
+    ~ScopedIsolation()
+    {
+#if defined(__linux__)
+        if (_realtime) {
+            (void)sched_setscheduler(0, _policy, &_param);
+        }
+        if (_pinned) {
+            (void)sched_setaffinity(0, sizeof(_affinity), &_affinity);
+        }
+#endif
+        if (_locked) {
+            unlock_memory();
+        }
+    }
+
+    /// @brief Copy constructor (deleted, the state can be restored only once).
+    ScopedIsolation(const ScopedIsolation &) = delete;
+
+    /// @brief Copy assignment operator (deleted, the state can be restored only once).
+    /// @return A reference to this object.
+    auto operator=(const ScopedIsolation &) -> ScopedIsolation & = delete;
+
+    /// @brief Returns the warnings raised while isolating the thread.
+    /// @return the warnings.
+    auto warnings() const -> const std::vector<std::string> & { return _warnings; }
+
+private:
+    /// @brief The warnings raised while isolating the thread.
+    std::vector<std::string> _warnings;
+    /// @brief If the thread has been pinned.
+    bool _pinned;
+    /// @brief If the scheduling policy has been changed.
+    bool _realtime;
+    /// @brief If the memory has been locked.
+    bool _locked;
+#if defined(__linux__)
+    /// @brief The previous affinity of the thread.
+    cpu_set_t _affinity;
+    /// @brief The previous scheduling policy of the thread.
+    int _policy;
+    /// @brief The previous scheduling parameters of the thread.
+    struct sched_param _param;
+#endif
+};
+
+} // namespace timelib
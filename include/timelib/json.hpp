@@ -0,0 +1,297 @@
+/// @file json.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines a minimal JSON value, writer and parser, used by the result files.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/config.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace timelib
+{
+
+namespace detail
+{
+
+/// @brief A JSON value.
+/// @details Objects keep their members in insertion order, which keeps the
+/// written files stable and easy to diff.
+class TIMELIB_API json_value_t
+{
+public:
+    /// @brief The type of a JSON value.
+    enum type_t : unsigned char {
+        null_type,   ///< null
+        bool_type,   ///< true or false
+        number_type, ///< a number
+        string_type, ///< a string
+        array_type,  ///< an array of values
+        object_type  ///< an object, with named members
+    };
+
+    /// @brief Constructs a null value.
+    json_value_t()
+        : _type(null_type)
+        , _bool(false)
+        , _number(0.)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Constructs a boolean value.
+    /// @param value the boolean.
+    /// @return the JSON value.
+    static auto boolean(bool value) -> json_value_t
+    {
+        json_value_t result;
+        result._type = bool_type;
+        result._bool = value;
+        return result;
+    }
+
+    /// @brief Constructs a number.
+    /// @param value the number.
+    /// @return the JSON value.
+    static auto number(double value) -> json_value_t
+    {
+        json_value_t result;
+        result._type   = number_type;
+        result._number = value;
+        return result;
+    }
+
+    /// @brief Constructs a string.
+    /// @param value the string.
+    /// @return the JSON value.
+    static auto string(std::string value) -> json_value_t
+    {
+        json_value_t result;
+        result._type   = string_type;
+        result._string = std::move(value);
+        return result;
+    }
+
+    /// @brief Constructs an empty array.
+    /// @return the JSON value.
+    static auto array() -> json_value_t
+    {
+        json_value_t result;
+        result._type = array_type;
+        return result;
+    }
+
+    /// @brief Constructs an empty object.
+    /// @return the JSON value.
+    static auto object() -> json_value_t
+    {
+        json_value_t result;
+        result._type = object_type;
+        return result;
+    }
+
+    /// @brief Returns the type of the value.
+    /// @return the type.
+    auto type() const -> type_t { return _type; }
+
+    /// @brief Returns the boolean.
+    /// @return the boolean.
+    /// @throw std::runtime_error if the value is not a boolean.
+    auto as_bool() const -> bool
+    {
+        this->expect(bool_type, "a boolean");
+        return _bool;
+    }
+
+    /// @brief Returns the number.
+    /// @return the number.
+    /// @throw std::runtime_error if the value is not a number.
+    auto as_number() const -> double
+    {
+        this->expect(number_type, "a number");
+        return _number;
+    }
+
+    /// @brief Returns the string.
+    /// @return the string.
+    /// @throw std::runtime_error if the value is not a string.
+    auto as_string() const -> const std::string &
+    {
+        this->expect(string_type, "a string");
+        return _string;
+    }
+
+    /// @brief Returns the elements of the array.
+    /// @return the elements.
+    /// @throw std::runtime_error if the value is not an array.
+    auto elements() const -> const std::vector<json_value_t> &
+    {
+        this->expect(array_type, "an array");
+        return _elements;
+    }
+
+    /// @brief Returns the members of the object.
+    /// @return the members.
+    /// @throw std::runtime_error if the value is not an object.
+    auto members() const -> const std::vector<std::pair<std::string, json_value_t> > &
+    {
+        this->expect(object_type, "an object");
+        return _members;
+    }
+
+    /// @brief Appends an element to the array.
+    /// @param value the element.
+    /// @return a reference to this value.
+    auto push_back(json_value_t value) -> json_value_t &
+    {
+        this->expect(array_type, "an array");
+        _elements.push_back(std::move(value));
+        return *this;
+    }
+
+    /// @brief Sets a member of the object.
+    /// @param key the name of the member.
+    /// @param value the value of the member.
+    /// @return a reference to this value.
+    auto set(const std::string &key, json_value_t value) -> json_value_t &
+    {
+        this->expect(object_type, "an object");
+        for (auto &member : _members) {
+            if (member.first == key) {
+                member.second = std::move(value);
+                return *this;
+            }
+        }
+        _members.emplace_back(key, std::move(value));
+        return *this;
+    }
+
+    /// @brief Checks if the object has a member.
+    /// @param key the name of the member.
+    /// @return true if the member exists.
+    auto contains(const std::string &key) const -> bool { return this->find(key) != nullptr; }
+
+    /// @brief Returns a member of the object.
+    /// @param key the name of the member.
+    /// @return a reference to the member.
+    /// @throw std::runtime_error if the member does not exist.
+    auto at(const std::string &key) const -> const json_value_t &
+    {
+        const json_value_t *value = this->find(key);
+        if (value == nullptr) {
+            throw std::runtime_error("Missing JSON member '" + key + "'.");
+        }
+        return *value;
+    }
+
+    /// @brief Serializes the value.
+    /// @param indent the indentation of nested values, in spaces (negative for a single line).
+    /// @return the JSON text.
+    auto dump(int indent = 2) const -> std::string;
+
+    /// @brief Parses a JSON text.
+    /// @param text the JSON text.
+    /// @return the parsed value.
+    /// @throw std::runtime_error if the text is not valid JSON.
+    static auto parse(const std::string &text) -> json_value_t;
+
+private:
+    /// @brief Checks the type of the value.
+    /// @param type the expected type.
+    /// @param description the description of the expected type, for the error message.
+    void expect(type_t type, const char *description) const
+    {
+        if (_type != type) {
+            throw std::runtime_error(std::string("The JSON value is not ") + description + ".");
+        }
+    }
+
+    /// @brief Looks for a member of the object.
+    /// @param key the name of the member.
+    /// @return a pointer to the member, or nullptr.
+    auto find(const std::string &key) const -> const json_value_t *
+    {
+        if (_type != object_type) {
+            return nullptr;
+        }
+        for (const auto &member : _members) {
+            if (member.first == key) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+
+    /// @brief Writes a string literal, escaping it.
+    /// @param output where the literal is written.
+    /// @param value the string.
+    static void dump_string(std::string &output, const std::string &value);
+
+    /// @brief Writes a line break followed by the indentation.
+    /// @param output where the indentation is written.
+    /// @param indent the indentation of each level.
+    /// @param level the nesting level.
+    static void dump_newline(std::string &output, int indent, int level);
+
+    /// @brief Serializes the value.
+    /// @param output where the value is written.
+    /// @param indent the indentation of each level.
+    /// @param level the nesting level.
+    void dump(std::string &output, int indent, int level) const;
+
+    /// @brief Throws a parsing error.
+    /// @param message the error message.
+    /// @param position the position of the error.
+    static void fail(const std::string &message, std::size_t position);
+
+    /// @brief Skips the whitespace.
+    /// @param text the JSON text.
+    /// @param position the current position, updated.
+    static void skip_whitespace(const std::string &text, std::size_t &position);
+
+    /// @brief Consumes a literal keyword.
+    /// @param text the JSON text.
+    /// @param position the current position, updated.
+    /// @param keyword the expected keyword.
+    static void consume(const std::string &text, std::size_t &position, const char *keyword);
+
+    /// @brief Parses a string literal.
+    /// @param text the JSON text.
+    /// @param position the current position, updated.
+    /// @return the unescaped string.
+    static auto parse_string(const std::string &text, std::size_t &position) -> std::string;
+
+    /// @brief Parses a value.
+    /// @param text the JSON text.
+    /// @param position the current position, updated.
+    /// @return the parsed value.
+    static auto parse_value(const std::string &text, std::size_t &position) -> json_value_t;
+
+    /// @brief The type of the value.
+    type_t _type;
+    /// @brief The boolean, for boolean values.
+    bool _bool;
+    /// @brief The number, for number values.
+    double _number;
+    /// @brief The string, for string values.
+    std::string _string;
+    /// @brief The elements, for arrays.
+    std::vector<json_value_t> _elements;
+    /// @brief The members, for objects.
+    std::vector<std::pair<std::string, json_value_t> > _members;
+};
+
+} // namespace detail
+
+} // namespace timelib
+
+#if !defined(TIMELIB_COMPILED_LIB)
+#include "timelib/detail/json_impl.hpp"
+#endif
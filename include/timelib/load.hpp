@@ -0,0 +1,411 @@
+/// @file load.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines an open-loop load generator, which measures the latency under a fixed arrival rate.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/histogram.hpp"
+#include "timelib/optimizer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <iomanip>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace timelib
+{
+
+/// @brief The distribution of the time between two consecutive requests.
+enum arrival_t : unsigned char {
+    arrival_constant, ///< Requests are evenly spaced.
+    arrival_poisson   ///< Requests arrive independently (exponential gaps), with bursts.
+};
+
+namespace detail
+{
+
+/// @brief The clock pacing the requests and timing their latencies, which
+/// is monotonic, so that adjustments of the system time (e.g., an NTP step)
+/// cannot shift the schedule or corrupt the latencies.
+using load_clock_t = std::chrono::steady_clock;
+
+/// @brief Returns the seconds between two instants.
+/// @param from the earlier instant.
+/// @param to the later instant.
+/// @return the seconds between them.
+inline auto seconds_between(const load_clock_t::time_point &from, const load_clock_t::time_point &to) -> double
+{
+    return std::chrono::duration_cast<std::chrono::duration<double> >(to - from).count();
+}
+
+/// @brief Waits until the given instant, sleeping while it is far away, and
+/// then yielding the processor until it is reached.
+/// @param start the reference instant.
+/// @param offset the seconds, after the reference, to wait for.
+inline void wait_until(const load_clock_t::time_point &start, double offset)
+{
+    for (;;) {
+        double remaining = offset - detail::seconds_between(start, load_clock_t::now());
+        if (remaining <= 0.) {
+            return;
+        }
+        // The sleep can overshoot by tens of microseconds, so the last part is not slept.
+        if (remaining > 200e-6) {
+            std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long>((remaining - 100e-6) * 1e6)));
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace detail
+
+/// @brief The options of an open-loop load run.
+struct load_options_t {
+    /// @brief Constructs the default options.
+    load_options_t()
+        : arrival(arrival_poisson)
+        , duration(1.)
+        , workers(1)
+        , seed(5489U)
+        , saturation(0.95)
+        , latency_growth(10.)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief The distribution of the time between two consecutive requests.
+    arrival_t arrival;
+    /// @brief For how long requests are issued at each rate, in seconds.
+    double duration;
+    /// @brief The number of threads of the executor serving the requests.
+    std::size_t workers;
+    /// @brief Seed of the random generator of the arrivals, so that the schedule is reproducible.
+    std::uint64_t seed;
+    /// @brief A rate is saturated when the completed requests per second fall below this fraction of it.
+    double saturation;
+    /// @brief A rate is saturated when its 99th percentile latency grows past this factor of the lowest rate's one.
+    double latency_growth;
+};
+
+/// @brief The results of an open-loop load run, at a fixed arrival rate.
+struct load_result_t {
+    /// @brief Constructs an empty result.
+    load_result_t()
+        : name()
+        , offered_rate(0.)
+        , achieved_rate(0.)
+        , issued(0)
+        , completed(0)
+        , lag(0.)
+        , latency()
+        , service()
+    {
+        // Nothing to do.
+    }
+
+    /// @brief The name of the load run.
+    std::string name;
+    /// @brief The requests per second issued by the pacer.
+    double offered_rate;
+    /// @brief The requests per second completed by the executor.
+    double achieved_rate;
+    /// @brief The number of issued requests.
+    std::size_t issued;
+    /// @brief The number of completed requests.
+    std::size_t completed;
+    /// @brief The largest delay of the pacer with respect to the schedule, in seconds.
+    double lag;
+    /// @brief The time from the intended start of each request to its end,
+    /// which includes the time spent waiting for a worker.
+    Histogram latency;
+    /// @brief The time spent by a worker executing each request.
+    Histogram service;
+
+    /// @brief Converts the results to a string.
+    /// @return the string representation of the results.
+    auto to_string() const -> std::string
+    {
+        std::stringstream ss;
+        ss << name << ": offered " << std::fixed << std::setprecision(1) << offered_rate << "/s, achieved "
+           << achieved_rate << "/s, " << completed << " of " << issued << " requests, pacer lag "
+           << detail::format_time(lag) << "\n";
+        ss << "  latency : " << latency << "\n";
+        ss << "  service : " << service << "\n";
+        return ss.str();
+    }
+
+    /// @brief Prints the results to an output stream.
+    /// @param lhs The output stream.
+    /// @param rhs The results to print.
+    /// @return The modified output stream.
+    friend auto operator<<(std::ostream &lhs, const load_result_t &rhs) -> std::ostream &
+    {
+        return (lhs << rhs.to_string());
+    }
+};
+
+/// @brief The results of a sweep over increasing arrival rates.
+struct load_sweep_t {
+    /// @brief The name of the load run.
+    std::string name;
+    /// @brief The results at each rate, in increasing order.
+    std::vector<load_result_t> runs;
+    /// @brief Whether each run has saturated the executor.
+    std::vector<bool> saturated;
+
+    /// @brief Returns the index of the saturation knee, i.e., the highest
+    /// rate sustained before the first saturated one.
+    /// @return the index of the run, or the number of runs if the first one is already saturated.
+    auto knee() const -> std::size_t
+    {
+        std::size_t first = static_cast<std::size_t>(
+            std::find(saturated.begin(), saturated.end(), true) - saturated.begin());
+        return (first > 0) ? (first - 1) : runs.size();
+    }
+
+    /// @brief Returns the highest rate sustained by the executor.
+    /// @return the completed requests per second at the knee, zero if no rate was sustained.
+    auto max_sustainable_rate() const -> double
+    {
+        std::size_t index = this->knee();
+        return (index < runs.size()) ? runs[index].achieved_rate : 0.;
+    }
+
+    /// @brief Converts the results to a table, with a row for each rate.
+    /// @return the string representation of the results.
+    auto to_string() const -> std::string
+    {
+        std::stringstream ss;
+        ss << std::left << std::setw(32) << name << std::right << std::setw(14) << "offered/s" << std::setw(14)
+           << "achieved/s" << std::setw(14) << "p50" << std::setw(14) << "p99" << std::setw(14) << "p99.9"
+           << "\n";
+        std::size_t index = this->knee();
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            const load_result_t &run = runs[i];
+            ss << std::left << std::setw(32) << ("  #" + std::to_string(i)) << std::right << std::fixed
+               << std::setprecision(1) << std::setw(14) << run.offered_rate << std::setw(14) << run.achieved_rate
+               << std::setw(14) << detail::format_time(run.latency.percentile(50.)) << std::setw(14)
+               << detail::format_time(run.latency.percentile(99.)) << std::setw(14)
+               << detail::format_time(run.latency.percentile(99.9)) << (saturated[i] ? " *" : "")
+               << ((i == index) ? " <- knee" : "") << "\n";
+        }
+        return ss.str();
+    }
+
+    /// @brief Prints the results to an output stream.
+    /// @param lhs The output stream.
+    /// @param rhs The results to print.
+    /// @return The modified output stream.
+    friend auto operator<<(std::ostream &lhs, const load_sweep_t &rhs) -> std::ostream &
+    {
+        return (lhs << rhs.to_string());
+    }
+};
+
+/// @brief An open-loop load generator, which issues requests on a schedule
+/// that does not depend on how fast they are served.
+/// @details A closed loop, like ntimes(), issues a request only after the
+/// previous one has finished, so it never builds a queue and hides the
+/// queueing delay. Here the calling thread acts as a pacer, which pushes the
+/// intended start time of each request into a queue, served by a pool of
+/// workers. The latency is measured from the intended start time, so a late
+/// pacer or a busy executor cannot hide the delay (coordinated omission).
+class LoadGenerator
+{
+public:
+    /// @brief Constructs a LoadGenerator.
+    /// @param name the name of the load run.
+    /// @param options the options of the run.
+    explicit LoadGenerator(std::string name, load_options_t options = load_options_t())
+        : _name(std::move(name))
+        , _options(options)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the name of the load run.
+    /// @return the name.
+    auto name() const -> const std::string & { return _name; }
+
+    /// @brief Returns the options of the load run.
+    /// @return a reference to the options.
+    auto options() -> load_options_t & { return _options; }
+
+    /// @brief Issues requests at the given rate, for the duration in the options.
+    /// @param function the request handler, which must be thread-safe when there are several workers.
+    /// @param rate the requests per second.
+    /// @return the results of the run.
+    /// @throw std::invalid_argument if the rate is not positive, or there are no workers.
+    template <class Function>
+    auto run(const Function &function, double rate) -> load_result_t
+    {
+        if (rate <= 0.) {
+            throw std::invalid_argument("A load run needs a positive rate.");
+        }
+        if (_options.workers == 0) {
+            throw std::invalid_argument("A load run needs at least one worker.");
+        }
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::deque<double> queue;
+        bool done = false;
+        // Each worker records its own histograms, which are merged at the end.
+        std::vector<Histogram> latencies(_options.workers);
+        std::vector<Histogram> services(_options.workers);
+        std::vector<double> last_end(_options.workers, 0.);
+        std::vector<std::exception_ptr> errors(_options.workers);
+        detail::load_clock_t::time_point start = detail::load_clock_t::now();
+
+        std::vector<std::thread> workers;
+        workers.reserve(_options.workers);
+        for (std::size_t i = 0; i < _options.workers; ++i) {
+            workers.emplace_back([&, i]() {
+                for (;;) {
+                    double intended = 0.;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        ready.wait(lock, [&]() { return done || !queue.empty(); });
+                        if (queue.empty()) {
+                            return;
+                        }
+                        intended = queue.front();
+                        queue.pop_front();
+                    }
+                    double begin = detail::seconds_between(start, detail::load_clock_t::now());
+                    if (!errors[i]) {
+                        try {
+                            detail::invoke_opaque(function);
+                        } catch (...) {
+                            errors[i] = std::current_exception();
+                        }
+                    }
+                    double end = detail::seconds_between(start, detail::load_clock_t::now());
+                    latencies[i].record(end - intended);
+                    services[i].record(end - begin);
+                    last_end[i] = end;
+                }
+            });
+        }
+
+        load_result_t result;
+        result.name         = _name;
+        result.offered_rate = rate;
+        std::mt19937_64 engine(_options.seed);
+        std::exponential_distribution<double> gap(rate);
+        for (double next = 0.; next < _options.duration; ++result.issued) {
+            detail::wait_until(start, next);
+            result.lag = std::max(result.lag, detail::seconds_between(start, detail::load_clock_t::now()) - next);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back(next);
+            }
+            ready.notify_one();
+            next += (_options.arrival == arrival_poisson) ? gap(engine) : (1. / rate);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+        }
+        ready.notify_all();
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        for (const auto &error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        for (std::size_t i = 0; i < _options.workers; ++i) {
+            result.latency.merge(latencies[i]);
+            result.service.merge(services[i]);
+        }
+        double elapsed       = *std::max_element(last_end.begin(), last_end.end());
+        result.completed     = static_cast<std::size_t>(result.latency.count());
+        result.achieved_rate = (elapsed > 0.) ? (static_cast<double>(result.completed) / elapsed) : 0.;
+        return result;
+    }
+
+    /// @brief Runs the load at each of the given rates, and stops at the
+    /// first one that saturates the executor, whose queue would otherwise
+    /// take longer and longer to drain.
+    /// @param function the request handler.
+    /// @param rates the requests per second, in increasing order.
+    /// @return the results of the runs.
+    template <class Function>
+    auto sweep(const Function &function, const std::vector<double> &rates) -> load_sweep_t
+    {
+        load_sweep_t result;
+        result.name = _name;
+        for (double rate : rates) {
+            if (this->add(result, this->run(function, rate))) {
+                break;
+            }
+        }
+        return result;
+    }
+
+    /// @brief Multiplies the rate by the given factor, until the executor saturates.
+    /// @param function the request handler.
+    /// @param initial_rate the first rate, in requests per second.
+    /// @param factor the ratio between consecutive rates.
+    /// @param max_runs the upper bound to the number of runs.
+    /// @return the results of the runs.
+    /// @throw std::invalid_argument if the factor is not greater than one.
+    template <class Function>
+    auto saturate(const Function &function, double initial_rate, double factor = 2., std::size_t max_runs = 32)
+        -> load_sweep_t
+    {
+        if (factor <= 1.) {
+            throw std::invalid_argument("The rate must grow at each run.");
+        }
+        load_sweep_t result;
+        result.name = _name;
+        double rate = initial_rate;
+        for (std::size_t i = 0; i < max_runs; ++i, rate *= factor) {
+            if (this->add(result, this->run(function, rate))) {
+                break;
+            }
+        }
+        return result;
+    }
+
+private:
+    /// @brief Adds a run to a sweep, and checks whether it has saturated the executor.
+    /// @param sweep the sweep.
+    /// @param run the results of the run.
+    /// @return true if the run has saturated the executor.
+    auto add(load_sweep_t &sweep, const load_result_t &run) const -> bool
+    {
+        bool saturated = run.achieved_rate < (_options.saturation * run.offered_rate);
+        if (!sweep.runs.empty()) {
+            double reference = sweep.runs.front().latency.percentile(99.);
+            saturated        = saturated || (run.latency.percentile(99.) > (_options.latency_growth * reference));
+        }
+        sweep.runs.push_back(run);
+        sweep.saturated.push_back(saturated);
+        return saturated;
+    }
+
+    /// @brief The name of the load run.
+    std::string _name;
+    /// @brief The options of the run.
+    load_options_t _options;
+};
+
+} // namespace timelib
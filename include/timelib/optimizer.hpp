@@ -0,0 +1,141 @@
+/// @file optimizer.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the compiler barriers that keep measured work from being optimized away.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include <atomic>
+#include <type_traits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace timelib
+{
+
+#if defined(__GNUC__) || defined(__clang__)
+
+/// @brief Forces the compiler to assume the value is read, so the code
+/// computing it cannot be removed or hoisted out of a loop.
+/// @param value the value to keep alive.
+template <class T>
+inline auto do_not_optimize(const T &value) ->
+    typename std::enable_if<std::is_trivially_copyable<T>::value && (sizeof(T) <= sizeof(T *))>::type
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// @brief Forces the compiler to assume the value is read, so the code
+/// computing it cannot be removed or hoisted out of a loop.
+/// @param value the value to keep alive.
+template <class T>
+inline auto do_not_optimize(const T &value) ->
+    typename std::enable_if<!std::is_trivially_copyable<T>::value || (sizeof(T) > sizeof(T *))>::type
+{
+    asm volatile("" : : "m"(value) : "memory");
+}
+
+/// @brief Forces the compiler to assume the value is read and modified, so
+/// neither the code computing it nor the code using it can be removed.
+/// @param value the value to keep alive.
+template <class T>
+inline auto do_not_optimize(T &value) ->
+    typename std::enable_if<std::is_trivially_copyable<T>::value && (sizeof(T) <= sizeof(T *))>::type
+{
+#if defined(__clang__)
+    asm volatile("" : "+r,m"(value) : : "memory");
+#else
+    // GCC can miscompile multi-alternative in-out constraints ("+m,r"), so
+    // small values are always kept in a register.
+    asm volatile("" : "+r"(value) : : "memory");
+#endif
+}
+
+/// @brief Forces the compiler to assume the value is read and modified, so
+/// neither the code computing it nor the code using it can be removed.
+/// @param value the value to keep alive.
+template <class T>
+inline auto do_not_optimize(T &value) ->
+    typename std::enable_if<!std::is_trivially_copyable<T>::value || (sizeof(T) > sizeof(T *))>::type
+{
+    asm volatile("" : "+m"(value) : : "memory");
+}
+
+/// @brief Forces all pending writes to be committed to memory, and all
+/// following reads to be performed from memory.
+inline void clobber_memory() { asm volatile("" : : : "memory"); }
+
+#else
+
+namespace detail
+{
+
+/// @brief Publishes the address of a value through a volatile sink, which the
+/// compiler cannot see through.
+/// @param pointer the address of the value.
+inline void use_char_pointer(const volatile char *pointer)
+{
+    static const volatile char *volatile sink = nullptr;
+    sink                                      = pointer;
+}
+
+} // namespace detail
+
+/// @brief Forces the compiler to assume the value is read, so the code
+/// computing it cannot be removed or hoisted out of a loop.
+/// @param value the value to keep alive.
+template <class T>
+inline void do_not_optimize(const T &value)
+{
+    detail::use_char_pointer(&reinterpret_cast<const volatile char &>(value));
+#if defined(_MSC_VER)
+    _ReadWriteBarrier();
+#else
+    std::atomic_signal_fence(std::memory_order_acq_rel);
+#endif
+}
+
+/// @brief Forces all pending writes to be committed to memory, and all
+/// following reads to be performed from memory.
+inline void clobber_memory()
+{
+#if defined(_MSC_VER)
+    _ReadWriteBarrier();
+#else
+    std::atomic_signal_fence(std::memory_order_acq_rel);
+#endif
+}
+
+#endif
+
+namespace detail
+{
+
+/// @brief Calls a function returning nothing, and forces its writes to memory.
+/// @param function the function to call.
+template <class Function>
+inline auto invoke_opaque(const Function &function) ->
+    typename std::enable_if<std::is_void<decltype(function())>::value>::type
+{
+    function();
+    clobber_memory();
+}
+
+/// @brief Calls a function, and keeps its result alive.
+/// @param function the function to call.
+template <class Function>
+inline auto invoke_opaque(const Function &function) ->
+    typename std::enable_if<!std::is_void<decltype(function())>::value>::type
+{
+    auto &&result = function();
+    do_not_optimize(result);
+}
+
+} // namespace detail
+
+} // namespace timelib
@@ -0,0 +1,335 @@
+/// @file registry.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the static registration of benchmarks, and a reusable main to list, filter and run them.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/config.hpp"
+#include "timelib/report.hpp"
+#include "timelib/scheduler.hpp"
+
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// @brief Defines and registers a benchmark, whose body is run at each iteration.
+/// @details Usage:
+///     TIMELIB_BENCHMARK(sort_small) { ... }
+#define TIMELIB_BENCHMARK(name)                                                                                        \
+    static void TIMELIB_CONCAT(timelib_benchmark_, name)();                                                            \
+    static const bool TIMELIB_CONCAT(timelib_registered_, name) =                                                      \
+        timelib::register_benchmark(#name, &TIMELIB_CONCAT(timelib_benchmark_, name));                                 \
+    static void TIMELIB_CONCAT(timelib_benchmark_, name)()
+
+/// @brief Defines a main that runs the registered benchmarks, see timelib::run_main().
+#define TIMELIB_MAIN()                                                                                                 \
+    int main(int argc, char *argv[]) { return timelib::run_main(argc, argv); }
+
+namespace timelib
+{
+
+/// @brief A benchmark registered for discovery.
+struct registered_benchmark_t {
+    /// @brief The name of the benchmark.
+    std::string name;
+    /// @brief The function to benchmark.
+    std::function<void()> function;
+    /// @brief The options of the benchmark, which the command line can override.
+    benchmark_options_t options;
+};
+
+namespace detail
+{
+
+/// @brief Returns the registered benchmarks.
+/// @details A function-local static is built on first use, so benchmarks
+/// can be registered from the static initializers of any translation unit.
+/// @return a reference to the benchmarks.
+inline auto registry() -> std::vector<registered_benchmark_t> &
+{
+    static std::vector<registered_benchmark_t> benchmarks;
+    return benchmarks;
+}
+
+/// @brief Checks if a string starts with the given prefix.
+/// @param text the string.
+/// @param prefix the prefix.
+/// @return true if the string starts with the prefix.
+inline auto starts_with(const std::string &text, const std::string &prefix) -> bool
+{
+    return text.compare(0, prefix.size(), prefix) == 0;
+}
+
+/// @brief Parses the value of a command-line option as an unsigned integer.
+/// @param argument the whole argument, for the error message.
+/// @param text the value.
+/// @return the integer.
+/// @throw std::invalid_argument if the value is not made only of decimal digits, or is too large.
+inline auto parse_unsigned(const std::string &argument, const std::string &text) -> std::uint64_t
+{
+    char *end = nullptr;
+    errno     = 0;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    // strtoull accepts leading blanks and a sign, which are not valid here.
+    if (text.empty() || (text[0] < '0') || (text[0] > '9') || (end != (text.c_str() + text.size())) ||
+        (errno == ERANGE)) {
+        throw std::invalid_argument("Invalid value in '" + argument + "', expected an unsigned integer.");
+    }
+    return static_cast<std::uint64_t>(value);
+}
+
+/// @brief Parses the value of a command-line option as a finite number.
+/// @param argument the whole argument, for the error message.
+/// @param text the value.
+/// @return the number.
+/// @throw std::invalid_argument if the value is not entirely a finite number.
+inline auto parse_number(const std::string &argument, const std::string &text) -> double
+{
+    char *end    = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (text.empty() || std::isspace(static_cast<unsigned char>(text[0])) ||
+        (end != (text.c_str() + text.size())) || !std::isfinite(value)) {
+        throw std::invalid_argument("Invalid value in '" + argument + "', expected a number.");
+    }
+    return value;
+}
+
+} // namespace detail
+
+/// @brief Registers a benchmark.
+/// @param name the name of the benchmark.
+/// @param function the function to benchmark.
+/// @param options the options of the benchmark.
+/// @return always true, so that it can initialize a static variable.
+inline auto register_benchmark(
+    std::string name,
+    std::function<void()> function,
+    const benchmark_options_t &options = benchmark_options_t()) -> bool
+{
+    registered_benchmark_t benchmark;
+    benchmark.name     = std::move(name);
+    benchmark.function = std::move(function);
+    benchmark.options  = options;
+    detail::registry().push_back(benchmark);
+    return true;
+}
+
+/// @brief Returns the registered benchmarks, in order of registration.
+/// @return a const reference to the benchmarks.
+inline auto registered_benchmarks() -> const std::vector<registered_benchmark_t> & { return detail::registry(); }
+
+/// @brief Selects the registered benchmarks whose name matches a regular expression.
+/// @param filter the regular expression (ECMAScript), searched anywhere in the name.
+/// @return the matching benchmarks, in order of registration.
+/// @throw std::regex_error if the regular expression is not valid.
+inline auto select_benchmarks(const std::string &filter) -> std::vector<registered_benchmark_t>
+{
+    std::regex pattern(filter);
+    std::vector<registered_benchmark_t> result;
+    for (const auto &benchmark : detail::registry()) {
+        if (std::regex_search(benchmark.name, pattern)) {
+            result.push_back(benchmark);
+        }
+    }
+    return result;
+}
+
+/// @brief The options given on the command line of run_main().
+struct command_line_t {
+    /// @brief Constructs the default options.
+    command_line_t()
+        : help(false)
+        , list(false)
+        , filter(".*")
+        , repetitions(0)
+        , min_time(0.)
+        , warmup_time(-1.)
+        , format(console)
+        , output()
+        , interleave(true)
+        , seed(0)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Prints the usage, without running the benchmarks.
+    bool help;
+    /// @brief Lists the selected benchmarks instead of running them.
+    bool list;
+    /// @brief The regular expression selecting the benchmarks.
+    std::string filter;
+    /// @brief Overrides the number of repetitions, when not zero.
+    std::size_t repetitions;
+    /// @brief Overrides the target time of each repetition, in seconds, when positive.
+    double min_time;
+    /// @brief Overrides the warmup time, in seconds, when not negative.
+    double warmup_time;
+    /// @brief The format of the results.
+    output_format_t format;
+    /// @brief The file receiving the results, empty for the standard output.
+    std::string output;
+    /// @brief Shuffles the repetitions of the selected benchmarks.
+    bool interleave;
+    /// @brief Seed of the shuffle, zero to draw a new one.
+    std::uint64_t seed;
+
+    /// @brief Parses the command line.
+    /// @param argc the number of arguments.
+    /// @param argv the arguments, the first one being the program.
+    /// @return the options.
+    /// @throw std::invalid_argument if an argument is not valid.
+    static auto parse(int argc, char *argv[]) -> command_line_t
+    {
+        command_line_t result;
+        bool has_format = false;
+        for (int i = 1; i < argc; ++i) {
+            std::string argument(argv[i]);
+            if ((argument == "--help") || (argument == "-h")) {
+                result.help = true;
+            } else if (argument == "--list") {
+                result.list = true;
+            } else if (detail::starts_with(argument, "--filter=")) {
+                result.filter = argument.substr(9);
+            } else if (detail::starts_with(argument, "--repetitions=")) {
+                result.repetitions = static_cast<std::size_t>(detail::parse_unsigned(argument, argument.substr(14)));
+            } else if (detail::starts_with(argument, "--min-time=")) {
+                result.min_time = detail::parse_number(argument, argument.substr(11));
+            } else if (detail::starts_with(argument, "--warmup=")) {
+                result.warmup_time = detail::parse_number(argument, argument.substr(9));
+            } else if (argument == "--format=console") {
+                result.format = console;
+                has_format    = true;
+            } else if (argument == "--format=json") {
+                result.format = json;
+                has_format    = true;
+            } else if (argument == "--format=csv") {
+                result.format = csv;
+                has_format    = true;
+            } else if (detail::starts_with(argument, "--output=")) {
+                result.output = argument.substr(9);
+            } else if (argument == "--no-interleave") {
+                result.interleave = false;
+            } else if (detail::starts_with(argument, "--seed=")) {
+                result.seed = detail::parse_unsigned(argument, argument.substr(7));
+            } else {
+                throw std::invalid_argument("Unknown argument '" + argument + "'.");
+            }
+        }
+        // Files default to JSON (or CSV, by extension), which can be compared later.
+        if (!has_format && !result.output.empty()) {
+            bool is_csv   = (result.output.size() > 4) && (result.output.substr(result.output.size() - 4) == ".csv");
+            result.format = is_csv ? csv : json;
+        }
+        return result;
+    }
+
+    /// @brief Applies the overrides of the command line to the options of a benchmark.
+    /// @param options the options of the benchmark.
+    void apply(benchmark_options_t &options) const
+    {
+        if (repetitions > 0) {
+            options.repetitions = repetitions;
+        }
+        if (min_time > 0.) {
+            options.min_time = min_time;
+        }
+        if (warmup_time >= 0.) {
+            options.warmup_time = warmup_time;
+        }
+    }
+};
+
+/// @brief Prints the usage of run_main().
+/// @param program the name of the program.
+inline void print_usage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "Options:\n"
+              << "    --list                         list the selected benchmarks, without running them\n"
+              << "    --filter=<regex>               run only the benchmarks whose name matches\n"
+              << "    --repetitions=<n>              number of repetitions of each benchmark\n"
+              << "    --min-time=<seconds>           target time of each repetition\n"
+              << "    --warmup=<seconds>             warmup time of each benchmark\n"
+              << "    --format=<console|json|csv>    format of the results (default console, json for files)\n"
+              << "    --output=<path>                write the results to a file, instead of the standard output\n"
+              << "    --no-interleave                run the benchmarks one after the other\n"
+              << "    --seed=<n>                     seed of the order of the repetitions (default random)\n";
+}
+
+/// @brief Runs the registered benchmarks, as selected by the command line.
+/// @details The repetitions of the selected benchmarks are interleaved by a
+/// Scheduler, whose seed is printed and stored in the report, so that the
+/// same order can be replayed with --seed.
+/// @param argc the number of arguments.
+/// @param argv the arguments, the first one being the program.
+/// @return 0 on success, 1 when no benchmark matches the filter, 2 on errors.
+inline auto run_main(int argc, char *argv[]) -> int
+{
+    command_line_t command_line;
+    std::vector<registered_benchmark_t> selected;
+    try {
+        command_line = command_line_t::parse(argc, argv);
+        selected     = timelib::select_benchmarks(command_line.filter);
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        timelib::print_usage(argv[0]);
+        return 2;
+    }
+    if (command_line.help) {
+        timelib::print_usage(argv[0]);
+        return 0;
+    }
+    if (selected.empty()) {
+        std::cerr << "No benchmark matches '" << command_line.filter << "'.\n";
+        return 1;
+    }
+    if (command_line.list) {
+        for (const auto &benchmark : selected) {
+            std::cout << benchmark.name << "\n";
+        }
+        return 0;
+    }
+    try {
+        Scheduler scheduler;
+        scheduler.options().interleave = command_line.interleave;
+        scheduler.options().seed       = command_line.seed;
+        for (auto &benchmark : selected) {
+            command_line.apply(benchmark.options);
+            scheduler.add(benchmark.name, benchmark.function, benchmark.options);
+        }
+        schedule_result_t schedule = scheduler.run();
+        report_t report;
+        report.environment = timelib::capture_environment();
+        report.environment.set("seed", std::to_string(schedule.seed));
+        report.results = schedule.results;
+        if (!command_line.output.empty()) {
+            report.save(command_line.output, command_line.format);
+        } else {
+            if (command_line.format == console) {
+                std::cout << "Repetitions " << (command_line.interleave ? "interleaved" : "in order") << ", seed "
+                          << schedule.seed << "\n\n";
+            }
+            std::cout << report.format(command_line.format);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 2;
+    }
+    return 0;
+}
+
+} // namespace timelib
@@ -0,0 +1,377 @@
+/// @file report.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines machine-readable benchmark reports, and the comparison against a baseline.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/compare.hpp"
+#include "timelib/config.hpp"
+#include "timelib/json.hpp"
+#include "timelib/version.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace timelib
+{
+
+/// @brief The format of a benchmark report.
+enum output_format_t : unsigned char {
+    console, ///< Human readable tables.
+    json,    ///< JSON, with the environment and all the repetitions.
+    csv      ///< CSV, with a row per repetition, and the environment as comments.
+};
+
+/// @brief The environment in which the benchmarks were run.
+/// @details The environment is stored as an ordered list of key/value pairs,
+/// so that it can be extended without changing the file format.
+struct environment_t {
+    /// @brief The properties of the environment.
+    std::vector<std::pair<std::string, std::string> > properties;
+
+    /// @brief Returns the value of a property.
+    /// @param key the name of the property.
+    /// @return the value, or an empty string if the property is not set.
+    auto get(const std::string &key) const -> std::string
+    {
+        for (const auto &property : properties) {
+            if (property.first == key) {
+                return property.second;
+            }
+        }
+        return std::string();
+    }
+
+    /// @brief Sets the value of a property.
+    /// @param key the name of the property.
+    /// @param value the value.
+    void set(const std::string &key, const std::string &value)
+    {
+        for (auto &property : properties) {
+            if (property.first == key) {
+                property.second = value;
+                return;
+            }
+        }
+        properties.emplace_back(key, value);
+    }
+};
+
+namespace detail
+{
+
+/// @brief Returns the name and version of the compiler.
+/// @return the compiler.
+inline auto compiler_version() -> std::string
+{
+#if defined(__clang__)
+    return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+    return std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+    return "unknown";
+#endif
+}
+
+/// @brief Returns the current date and time, in UTC and ISO 8601 format.
+/// @return the date and time.
+TIMELIB_INLINE auto utc_timestamp() -> std::string;
+
+/// @brief Returns the name of the machine.
+/// @return the host name.
+TIMELIB_INLINE auto host_name() -> std::string;
+
+/// @brief Returns the name and release of the operating system.
+/// @return the operating system.
+TIMELIB_INLINE auto operating_system() -> std::string;
+
+/// @brief Returns the first line of a file, typically from procfs or sysfs.
+/// @param path the path of the file.
+/// @return the line, or an empty string if the file cannot be read.
+TIMELIB_INLINE auto read_first_line(const std::string &path) -> std::string;
+
+/// @brief Returns the model of the processor, from /proc/cpuinfo.
+/// @return the model, or an empty string if it is not known.
+TIMELIB_INLINE auto cpu_model() -> std::string;
+
+/// @brief Counts the physical cores, from the topology in sysfs.
+/// @return the number of distinct (package, core) pairs, zero if it is not known.
+TIMELIB_INLINE auto physical_cores() -> std::size_t;
+
+/// @brief Returns the caches of the first processor, from sysfs.
+/// @return the caches (e.g., "L1d 48K, L1i 32K, L2 2048K, L3 32768K"), or an empty string if they are not known.
+TIMELIB_INLINE auto cpu_caches() -> std::string;
+
+/// @brief Returns the frequency governors of the processors.
+/// @return the distinct governors, separated by commas, or an empty string if they are not known.
+TIMELIB_INLINE auto governors() -> std::string;
+
+/// @brief Returns the flags that affect the generated code, as far as the
+/// preprocessor can tell, preceded by TIMELIB_COMPILE_FLAGS if the build
+/// system defines it.
+/// @return the flags.
+inline auto compile_flags() -> std::string
+{
+    std::string result;
+#if defined(TIMELIB_COMPILE_FLAGS)
+    result += std::string(TIMELIB_COMPILE_FLAGS) + " ";
+#endif
+#if defined(__OPTIMIZE_SIZE__)
+    result += "-Os ";
+#elif defined(__OPTIMIZE__)
+    result += "-O ";
+#else
+    result += "-O0 ";
+#endif
+#if defined(NDEBUG)
+    result += "-DNDEBUG ";
+#endif
+#if defined(__FAST_MATH__)
+    result += "-ffast-math ";
+#endif
+#if defined(__SANITIZE_ADDRESS__)
+    result += "-fsanitize=address ";
+#endif
+#if defined(__AVX512F__)
+    result += "avx512f ";
+#endif
+#if defined(__AVX2__)
+    result += "avx2 ";
+#endif
+#if defined(__FMA__)
+    result += "fma ";
+#endif
+#if defined(__SSE4_2__)
+    result += "sse4.2 ";
+#endif
+#if defined(__ARM_NEON)
+    result += "neon ";
+#endif
+    result.erase(result.find_last_not_of(' ') + 1);
+    return result;
+}
+
+/// @brief Quotes a CSV field, if needed.
+/// @param field the field.
+/// @return the escaped field.
+TIMELIB_INLINE auto csv_escape(const std::string &field) -> std::string;
+
+} // namespace detail
+
+/// @brief Captures the environment in which the benchmarks are running.
+/// @return the environment.
+inline auto capture_environment() -> environment_t
+{
+    environment_t environment;
+    environment.set(
+        "timelib", std::to_string(TIMELIB_MAJOR_VERSION) + "." + std::to_string(TIMELIB_MINOR_VERSION) + "." +
+                       std::to_string(TIMELIB_MICRO_VERSION));
+    environment.set("date", detail::utc_timestamp());
+    environment.set("host", detail::host_name());
+    environment.set("os", detail::operating_system());
+    environment.set("cpus", std::to_string(std::thread::hardware_concurrency()));
+    // The hardware and the kernel settings, where the system exposes them.
+    std::string smt = detail::read_first_line("/sys/devices/system/cpu/smt/active");
+    std::vector<std::pair<std::string, std::string> > optional = {
+        {"cpu_model", detail::cpu_model()},
+        {"caches", detail::cpu_caches()},
+        {"smt", smt.empty() ? smt : ((smt == "1") ? "on" : "off")},
+        {"governor", detail::governors()},
+        {"clocksource", detail::read_first_line("/sys/devices/system/clocksource/clocksource0/current_clocksource")},
+    };
+    std::size_t cores = detail::physical_cores();
+    if (cores > 0) {
+        environment.set("cores", std::to_string(cores));
+    }
+    for (const auto &property : optional) {
+        if (!property.second.empty()) {
+            environment.set(property.first, property.second);
+        }
+    }
+    environment.set("compiler", detail::compiler_version());
+    environment.set("flags", detail::compile_flags());
+#if defined(NDEBUG)
+    environment.set("build", "release");
+#else
+    environment.set("build", "debug");
+#endif
+    environment.set("clock", timespec_t::clock_name());
+    environment.set("clock_resolution", detail::format_time(timespec_t::resolution().count()));
+    return environment;
+}
+
+/// @brief Compares two environments, ignoring the properties that change at
+/// every run (the date and the seed of the schedule).
+/// @param baseline the environment of the baseline.
+/// @param current the current environment.
+/// @return a message for each property that differs.
+TIMELIB_INLINE auto compare_environments(const environment_t &baseline, const environment_t &current)
+    -> std::vector<std::string>;
+
+/// @brief A benchmark report, made of the environment and the results of the benchmarks.
+struct TIMELIB_API report_t {
+    /// @brief The environment in which the benchmarks were run.
+    environment_t environment;
+    /// @brief The results of the benchmarks.
+    std::vector<benchmark_result_t> results;
+
+    /// @brief Looks for the results of a benchmark.
+    /// @param name the name of the benchmark.
+    /// @return a pointer to the results, or nullptr if there is no benchmark with that name.
+    auto find(const std::string &name) const -> const benchmark_result_t *
+    {
+        for (const auto &result : results) {
+            if (result.name == name) {
+                return &result;
+            }
+        }
+        return nullptr;
+    }
+
+    /// @brief Converts the report to JSON.
+    /// @return the JSON text.
+    auto to_json() const -> std::string;
+
+    /// @brief Converts the report to CSV, with a row for each repetition.
+    /// @return the CSV text.
+    auto to_csv() const -> std::string;
+
+    /// @brief Converts the report to human readable tables.
+    /// @return the tables.
+    auto to_string() const -> std::string;
+
+    /// @brief Converts the report to the given format.
+    /// @param format the format.
+    /// @return the formatted report.
+    auto format(output_format_t format) const -> std::string;
+
+    /// @brief Writes the report to a file.
+    /// @param path the path of the file.
+    /// @param format the format of the file.
+    /// @throw std::runtime_error if the file cannot be written.
+    void save(const std::string &path, output_format_t format = json) const;
+
+    /// @brief Parses a JSON report.
+    /// @param text the JSON text.
+    /// @return the report.
+    /// @throw std::runtime_error if the text is not a valid report.
+    static auto from_json(const std::string &text) -> report_t;
+
+    /// @brief Loads a JSON report from a file.
+    /// @param path the path of the file.
+    /// @return the report.
+    /// @throw std::runtime_error if the file cannot be read, or is not a valid report.
+    static auto load(const std::string &path) -> report_t;
+};
+
+/// @brief The options of the comparison against a baseline.
+struct baseline_options_t {
+    /// @brief Constructs the default options.
+    baseline_options_t()
+        : threshold(5.)
+        , alpha(0.05)
+        , test(mann_whitney)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief The relative change of the median, in percent, above which a slowdown is a regression.
+    double threshold;
+    /// @brief The significance level of the hypothesis test.
+    double alpha;
+    /// @brief The hypothesis test.
+    test_t test;
+};
+
+/// @brief The outcome of the comparison of a benchmark against its baseline.
+enum baseline_status_t : unsigned char {
+    unchanged, ///< The change is below the threshold, or not significant.
+    improved,  ///< The benchmark is significantly faster than the baseline.
+    regressed, ///< The benchmark is significantly slower than the baseline.
+    missing,     ///< The benchmark is not in both reports, or has no samples.
+    incomparable ///< The median of the baseline is zero, so the change cannot be computed.
+};
+
+/// @brief The comparison of a benchmark against its baseline.
+struct baseline_entry_t {
+    /// @brief The name of the benchmark.
+    std::string name;
+    /// @brief Median time per iteration in the baseline, in seconds.
+    double baseline;
+    /// @brief Median time per iteration in the current run, in seconds.
+    double current;
+    /// @brief Relative change of the median, in percent (positive when slower).
+    double change;
+    /// @brief The result of the hypothesis test.
+    test_result_t result;
+    /// @brief The outcome of the comparison.
+    baseline_status_t status;
+};
+
+/// @brief The comparison of a whole report against a baseline report.
+struct TIMELIB_API baseline_comparison_t {
+    /// @brief The comparison of each benchmark of the current report, and of those missing from it.
+    std::vector<baseline_entry_t> entries;
+    /// @brief The differences between the environments of the two reports.
+    std::vector<std::string> warnings;
+
+    /// @brief Checks if any benchmark regressed.
+    /// @return true if at least one benchmark regressed.
+    auto has_regressions() const -> bool
+    {
+        for (const auto &entry : entries) {
+            if (entry.status == regressed) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Converts the comparison to a table.
+    /// @return the string representation of the comparison.
+    auto to_string() const -> std::string;
+
+    /// @brief Prints the comparison to an output stream.
+    /// @param lhs The output stream.
+    /// @param rhs The comparison to print.
+    /// @return The modified output stream.
+    friend auto operator<<(std::ostream &lhs, const baseline_comparison_t &rhs) -> std::ostream &
+    {
+        return (lhs << rhs.to_string());
+    }
+};
+
+/// @brief Compares the benchmarks of a report against a baseline report.
+/// @details A benchmark regresses when its median time per iteration grows
+/// more than the threshold, and the hypothesis test on the per-repetition
+/// samples rejects the null hypothesis at the given significance level.
+/// A benchmark whose baseline median is zero is reported as incomparable,
+/// with a warning, instead of being given a change.
+/// @param baseline the baseline report.
+/// @param current the current report.
+/// @param options the options of the comparison.
+/// @return the comparison of each benchmark of the current report, followed
+/// by the benchmarks of the baseline missing from the current report, which
+/// are also reported as warnings.
+TIMELIB_INLINE auto compare_to_baseline(
+    const report_t &baseline,
+    const report_t &current,
+    const baseline_options_t &options = baseline_options_t()) -> baseline_comparison_t;
+
+} // namespace timelib
+
+#if !defined(TIMELIB_COMPILED_LIB)
+#include "timelib/detail/report_impl.hpp"
+#endif
@@ -0,0 +1,232 @@
+/// @file rusage.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the resource usage (getrusage) deltas of measured regions.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/stopwatch.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+
+namespace timelib
+{
+
+#if !defined(_WIN32)
+namespace detail
+{
+
+/// @brief Converts a timeval to seconds.
+/// @param value the timeval.
+/// @return the seconds.
+inline auto timeval_to_seconds(const struct timeval &value) -> double
+{
+    return static_cast<double>(value.tv_sec) + (static_cast<double>(value.tv_usec) / 1e6);
+}
+
+} // namespace detail
+#endif
+
+/// @brief The resources used by the calling thread, either absolute or as a delta over a region.
+struct resource_usage_t {
+    /// @brief Constructs an empty usage.
+    resource_usage_t()
+        : user_time(0.)
+        , system_time(0.)
+        , minor_faults(0)
+        , major_faults(0)
+        , voluntary_switches(0)
+        , involuntary_switches(0)
+        , block_inputs(0)
+        , block_outputs(0)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Time spent in user mode, in seconds.
+    double user_time;
+    /// @brief Time spent in kernel mode, in seconds.
+    double system_time;
+    /// @brief Page faults served without I/O.
+    long minor_faults;
+    /// @brief Page faults that required I/O.
+    long major_faults;
+    /// @brief Context switches due to the thread blocking (e.g., on I/O or a lock).
+    long voluntary_switches;
+    /// @brief Context switches due to the thread being preempted.
+    long involuntary_switches;
+    /// @brief Block input operations.
+    long block_inputs;
+    /// @brief Block output operations.
+    long block_outputs;
+
+    /// @brief Returns the resources used so far by the calling thread.
+    /// @details Uses RUSAGE_THREAD where available, and falls back to the
+    /// whole process (RUSAGE_SELF) elsewhere. On Windows the usage is empty.
+    /// @return the current usage.
+    static auto now() -> resource_usage_t
+    {
+        resource_usage_t result;
+#if !defined(_WIN32)
+        struct rusage usage = {};
+#if defined(RUSAGE_THREAD)
+        if (getrusage(RUSAGE_THREAD, &usage) != 0) {
+            return result;
+        }
+#else
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return result;
+        }
+#endif
+        result.user_time            = detail::timeval_to_seconds(usage.ru_utime);
+        result.system_time          = detail::timeval_to_seconds(usage.ru_stime);
+        result.minor_faults         = usage.ru_minflt;
+        result.major_faults         = usage.ru_majflt;
+        result.voluntary_switches   = usage.ru_nvcsw;
+        result.involuntary_switches = usage.ru_nivcsw;
+        result.block_inputs         = usage.ru_inblock;
+        result.block_outputs        = usage.ru_oublock;
+#endif
+        return result;
+    }
+
+    /// @brief Returns the total number of context switches.
+    /// @return the voluntary and involuntary switches.
+    auto context_switches() const -> long { return voluntary_switches + involuntary_switches; }
+
+    /// @brief Checks if the region has been interrupted by a context switch,
+    /// in which case its time includes the time spent by other threads.
+    /// @return true if there has been at least one context switch.
+    auto contaminated() const -> bool { return this->context_switches() > 0; }
+
+    /// @brief Computes the difference between two usages.
+    /// @param lhs the later usage.
+    /// @param rhs the earlier usage.
+    /// @return the delta.
+    friend auto operator-(const resource_usage_t &lhs, const resource_usage_t &rhs) -> resource_usage_t
+    {
+        resource_usage_t result;
+        result.user_time            = lhs.user_time - rhs.user_time;
+        result.system_time          = lhs.system_time - rhs.system_time;
+        result.minor_faults         = lhs.minor_faults - rhs.minor_faults;
+        result.major_faults         = lhs.major_faults - rhs.major_faults;
+        result.voluntary_switches   = lhs.voluntary_switches - rhs.voluntary_switches;
+        result.involuntary_switches = lhs.involuntary_switches - rhs.involuntary_switches;
+        result.block_inputs         = lhs.block_inputs - rhs.block_inputs;
+        result.block_outputs        = lhs.block_outputs - rhs.block_outputs;
+        return result;
+    }
+
+    /// @brief Converts the usage to a string.
+    /// @return the string representation of the usage.
+    auto to_string() const -> std::string
+    {
+        std::stringstream ss;
+        ss << "user=" << detail::format_time(user_time) << " sys=" << detail::format_time(system_time)
+           << " minflt=" << minor_faults << " majflt=" << major_faults << " nvcsw=" << voluntary_switches
+           << " nivcsw=" << involuntary_switches << " inblock=" << block_inputs << " oublock=" << block_outputs;
+        if (this->contaminated()) {
+            ss << " (contaminated)";
+        }
+        return ss.str();
+    }
+
+    /// @brief Prints the usage to an output stream.
+    /// @param lhs The output stream.
+    /// @param rhs The usage to print.
+    /// @return The modified output stream.
+    friend auto operator<<(std::ostream &lhs, const resource_usage_t &rhs) -> std::ostream &
+    {
+        return (lhs << rhs.to_string());
+    }
+};
+
+/// @brief Tracks the resource usage of consecutive regions of the calling
+/// thread, mirroring the rounds of a Stopwatch.
+class ResourceTracker
+{
+public:
+    /// @brief Constructs a ResourceTracker, and starts the first region.
+    ResourceTracker()
+        : _start(resource_usage_t::now())
+        , _rounds()
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Starts a new region, from the current usage.
+    void start() { _start = resource_usage_t::now(); }
+
+    /// @brief Resets the rounds, and starts a new region.
+    void reset()
+    {
+        _rounds.clear();
+        this->start();
+    }
+
+    /// @brief Closes the current region, stores its delta, and starts a new one.
+    /// @return the usage over the region.
+    auto round() -> resource_usage_t
+    {
+        resource_usage_t now   = resource_usage_t::now();
+        resource_usage_t delta = now - _start;
+        _rounds.push_back(delta);
+        _start = now;
+        return delta;
+    }
+
+    /// @brief Returns the usage of each round.
+    /// @return a const reference to the rounds.
+    auto rounds() const -> const std::vector<resource_usage_t> & { return _rounds; }
+
+    /// @brief Returns the number of rounds interrupted by a context switch.
+    /// @return the number of contaminated rounds.
+    auto contaminated() const -> std::size_t
+    {
+        std::size_t count = 0;
+        for (const auto &round : _rounds) {
+            count += round.contaminated() ? 1U : 0U;
+        }
+        return count;
+    }
+
+private:
+    /// @brief The usage at the start of the current region.
+    resource_usage_t _start;
+    /// @brief The usage of each closed region.
+    std::vector<resource_usage_t> _rounds;
+};
+
+/// @brief Runs the function, and samples both the elapsed time and the resource usage.
+/// @param stopwatch the stopwatch used to retrieve the elapse time.
+/// @param tracker the tracker used to retrieve the resource usage.
+/// @param function the function to sample.
+/// @return the same stopwatch passed as argument.
+template <class Function>
+inline auto time(Stopwatch &stopwatch, ResourceTracker &tracker, const Function &function) -> Stopwatch &
+{
+    return detail::time_tracked(stopwatch, tracker, 1U, function);
+}
+
+/// @brief Runs the function N times, and samples both the elapsed time and the resource usage.
+/// @param stopwatch the stopwatch used to retrieve the elapse time.
+/// @param tracker the tracker used to retrieve the resource usage.
+/// @param function the function to sample.
+/// @return the same stopwatch passed as argument.
+template <std::size_t N, class Function>
+inline auto ntimes(Stopwatch &stopwatch, ResourceTracker &tracker, const Function &function) -> Stopwatch &
+{
+    return detail::time_tracked(stopwatch, tracker, N, function);
+}
+
+} // namespace timelib
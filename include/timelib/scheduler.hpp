@@ -0,0 +1,168 @@
+/// @file scheduler.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines a scheduler that interleaves the repetitions of several benchmarks in a random order.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/benchmark.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace timelib
+{
+
+/// @brief The options of a scheduled run of several benchmarks.
+struct schedule_options_t {
+    /// @brief Constructs the default options.
+    schedule_options_t()
+        : interleave(true)
+        , seed(0)
+        , rewarm(true)
+        , isolation()
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Shuffles the repetitions of all the benchmarks, instead of running them one benchmark after the other.
+    bool interleave;
+    /// @brief Seed of the shuffle, zero to draw a new one (which is then recorded in the results).
+    std::uint64_t seed;
+    /// @brief Runs a tenth of the iterations, untimed, before each repetition
+    /// that follows a different benchmark, to restore its caches and predictors.
+    bool rewarm;
+    /// @brief Affinity, priority and memory locking of the whole run.
+    isolation_options_t isolation;
+};
+
+/// @brief The results of a scheduled run.
+struct schedule_result_t {
+    /// @brief The seed of the shuffle.
+    std::uint64_t seed;
+    /// @brief The index of the benchmark run in each slot.
+    std::vector<std::size_t> order;
+    /// @brief The results of each benchmark, in order of addition, with the
+    /// repetitions in the order they were run.
+    std::vector<benchmark_result_t> results;
+};
+
+namespace detail
+{
+
+/// @brief Shuffles a sequence with the Fisher-Yates algorithm.
+/// @details std::shuffle is implemented differently by each standard
+/// library, while the output of std::mt19937_64 and this loop are fully
+/// specified, so a recorded seed replays the same order everywhere.
+/// @param values the sequence to shuffle.
+/// @param seed the seed of the generator.
+template <typename T>
+inline void seeded_shuffle(std::vector<T> &values, std::uint64_t seed)
+{
+    std::mt19937_64 engine(seed);
+    for (std::size_t i = values.size(); i > 1; --i) {
+        // The modulo bias is below 2^-40 for any realistic number of repetitions.
+        auto j = static_cast<std::size_t>(engine() % static_cast<std::uint64_t>(i));
+        std::swap(values[i - 1], values[j]);
+    }
+}
+
+} // namespace detail
+
+/// @brief Runs several benchmarks, interleaving their repetitions.
+/// @details Running a benchmark to completion and then the next one lets
+/// slow drifts of the machine (thermal throttling, frequency ramps, other
+/// load) bias one benchmark against the other. The scheduler first warms up
+/// and calibrates each benchmark, as Benchmark::run() does, then runs all
+/// the repetitions in a random order drawn from a recorded seed, and finally
+/// gives back the repetitions of each benchmark on their own.
+class Scheduler
+{
+public:
+    /// @brief Constructs a Scheduler.
+    /// @param options the options of the run.
+    explicit Scheduler(schedule_options_t options = schedule_options_t())
+        : _options(options)
+        , _names()
+        , _functions()
+        , _benchmark_options()
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the options of the run.
+    /// @return a reference to the options.
+    auto options() -> schedule_options_t & { return _options; }
+
+    /// @brief Adds a benchmark.
+    /// @param name the name of the benchmark.
+    /// @param function the function to benchmark.
+    /// @param options the options of the benchmark (its isolation is replaced by the one of the scheduler).
+    void add(
+        std::string name,
+        std::function<void()> function,
+        const benchmark_options_t &options = benchmark_options_t())
+    {
+        _names.push_back(std::move(name));
+        _functions.push_back(std::move(function));
+        _benchmark_options.push_back(options);
+    }
+
+    /// @brief Returns the number of benchmarks.
+    /// @return the number of benchmarks.
+    auto size() const -> std::size_t { return _names.size(); }
+
+    /// @brief Runs the benchmarks.
+    /// @return the results of the run.
+    auto run() const -> schedule_result_t
+    {
+        schedule_result_t result;
+        result.seed = _options.seed;
+        if (result.seed == 0) {
+            std::random_device device;
+            result.seed = (static_cast<std::uint64_t>(device()) << 32U) | static_cast<std::uint64_t>(device());
+        }
+        ScopedIsolation isolation(_options.isolation);
+        std::vector<Benchmark> benchmarks;
+        std::vector<std::size_t> iterations;
+        for (std::size_t i = 0; i < _names.size(); ++i) {
+            benchmarks.emplace_back(_names[i], _benchmark_options[i]);
+            result.results.push_back(benchmarks[i].make_result());
+            result.results[i].warnings = isolation.warnings();
+            benchmarks[i].warmup(_functions[i]);
+            iterations.push_back(benchmarks[i].calibrate(_functions[i]));
+            result.order.insert(result.order.end(), _benchmark_options[i].repetitions, i);
+        }
+        if (_options.interleave) {
+            detail::seeded_shuffle(result.order, result.seed);
+        }
+        for (std::size_t slot = 0; slot < result.order.size(); ++slot) {
+            std::size_t index = result.order[slot];
+            if (_options.rewarm && ((slot == 0) || (result.order[slot - 1] != index))) {
+                (void)Benchmark::measure(_functions[index], std::max<std::size_t>(iterations[index] / 10, 1));
+            }
+            benchmarks[index].repeat(_functions[index], iterations[index], result.results[index]);
+        }
+        return result;
+    }
+
+private:
+    /// @brief The options of the run.
+    schedule_options_t _options;
+    /// @brief The names of the benchmarks.
+    std::vector<std::string> _names;
+    /// @brief The functions to benchmark.
+    std::vector<std::function<void()>> _functions;
+    /// @brief The options of each benchmark.
+    std::vector<benchmark_options_t> _benchmark_options;
+};
+
+} // namespace timelib
@@ -0,0 +1,493 @@
+/// @file statistics.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines robust statistics and bootstrap confidence intervals over benchmark samples.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/config.hpp"
+#include "timelib/stopwatch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace timelib
+{
+
+/// @brief Computes the arithmetic mean of the samples.
+/// @param samples the samples.
+/// @return the mean, or zero if there are no samples.
+template <typename T>
+auto mean(const std::vector<T> &samples) -> T;
+
+/// @brief Computes the unbiased sample variance.
+/// @param samples the samples.
+/// @return the variance, or zero if there are less than two samples.
+template <typename T>
+auto variance(const std::vector<T> &samples) -> T;
+
+/// @brief Computes the sample standard deviation.
+/// @param samples the samples.
+/// @return the standard deviation.
+template <typename T>
+auto stddev(const std::vector<T> &samples) -> T;
+
+/// @brief Computes a percentile of samples that are already sorted, interpolating linearly.
+/// @param sorted the sorted samples.
+/// @param percentage the percentile, between 0 and 100.
+/// @return the percentile.
+/// @throw std::invalid_argument if there are no samples, or the percentage is out of range.
+template <typename T>
+auto percentile_sorted(const std::vector<T> &sorted, double percentage) -> T;
+
+/// @brief Computes a percentile of the samples, interpolating linearly.
+/// @param samples the samples.
+/// @param percentage the percentile, between 0 and 100.
+/// @return the percentile.
+template <typename T>
+auto percentile(std::vector<T> samples, double percentage) -> T;
+
+/// @brief Computes the median of the samples.
+/// @param samples the samples.
+/// @return the median.
+template <typename T>
+auto median(const std::vector<T> &samples) -> T;
+
+/// @brief Computes the median absolute deviation from the median.
+/// @details The value is not scaled; multiply it by 1.4826 to estimate the
+/// standard deviation of normally distributed samples.
+/// @param samples the samples.
+/// @return the median absolute deviation.
+template <typename T>
+auto mad(const std::vector<T> &samples) -> T;
+
+/// @brief A confidence interval around an estimate.
+template <typename T>
+struct confidence_interval_t {
+    /// @brief The lower bound of the interval.
+    T lower;
+    /// @brief The point estimate, computed on the original samples.
+    T estimate;
+    /// @brief The upper bound of the interval.
+    T upper;
+    /// @brief The confidence level of the interval (e.g., 0.95).
+    double confidence;
+
+    /// @brief Returns the half-width of the interval.
+    /// @return the half-width.
+    auto half_width() const -> T { return (upper - lower) / T(2); }
+};
+
+/// @brief The options of a bootstrap.
+struct bootstrap_options_t {
+    /// @brief Constructs the default options.
+    bootstrap_options_t()
+        : resamples(10000)
+        , confidence(0.95)
+        , seed(5489U)
+        , threads(0)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Number of resamples.
+    std::size_t resamples;
+    /// @brief Confidence level of the intervals.
+    double confidence;
+    /// @brief Seed of the random generators, so that intervals are reproducible.
+    std::uint64_t seed;
+    /// @brief Number of threads performing the resampling (zero uses all the cores), which does not change the result.
+    std::size_t threads;
+};
+
+namespace detail
+{
+
+/// @brief The number of resamples drawn from the same generator, which is
+/// seeded from the seed of the options and the index of the block.
+const std::size_t bootstrap_block = 256;
+
+/// @brief Computes the estimator on the blocks of resamples assigned to a worker.
+/// @details The worker takes the blocks first, first + stride, and so on.
+/// Each block has its own generator, so the estimates do not depend on how
+/// many workers there are, nor on which worker computes a block.
+/// @param samples the original samples.
+/// @param estimator the estimator.
+/// @param estimates where the estimates are stored, one per resample.
+/// @param first the first block of the worker.
+/// @param stride the number of workers.
+/// @param seed the seed of the bootstrap.
+template <typename T, class Estimator>
+inline void bootstrap_blocks(
+    const std::vector<T> &samples,
+    const Estimator &estimator,
+    std::vector<T> &estimates,
+    std::size_t first,
+    std::size_t stride,
+    std::uint64_t seed)
+{
+    std::vector<T> resample(samples.size());
+    for (std::size_t begin = first * bootstrap_block; begin < estimates.size(); begin += stride * bootstrap_block) {
+        std::size_t end = std::min(begin + bootstrap_block, estimates.size());
+        std::mt19937_64 engine(seed + (begin / bootstrap_block));
+        std::uniform_int_distribution<std::size_t> pick(0, samples.size() - 1);
+        for (std::size_t i = begin; i < end; ++i) {
+            for (auto &value : resample) {
+                value = samples[pick(engine)];
+            }
+            estimates[i] = estimator(resample);
+        }
+    }
+}
+
+/// @brief Chooses how many threads should perform the resampling.
+/// @param options the bootstrap options.
+/// @param work the total number of values drawn by the bootstrap.
+/// @return the number of threads.
+inline auto bootstrap_threads(const bootstrap_options_t &options, std::size_t work) -> std::size_t
+{
+    // Spawning threads is not worth it for small bootstraps.
+    if (work < 100000U) {
+        return 1;
+    }
+    std::size_t threads = options.threads;
+    if (threads == 0) {
+        threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    std::size_t blocks = (options.resamples + bootstrap_block - 1) / bootstrap_block;
+    return std::max<std::size_t>(std::min(threads, blocks), 1);
+}
+
+} // namespace detail
+
+/// @brief Computes a percentile bootstrap confidence interval of an estimator.
+/// @details The resamples are drawn in blocks of detail::bootstrap_block,
+/// each one from a generator seeded with the seed of the options plus the
+/// index of the block, and the blocks are shared among the threads. The
+/// interval therefore depends only on the seed, and not on the number of
+/// threads or on the scheduling.
+/// @param samples the samples.
+/// @param estimator the estimator, a callable taking a const std::vector<T>& and returning T.
+/// @param options the bootstrap options.
+/// @return the confidence interval.
+/// @throw std::invalid_argument if there are no samples.
+template <typename T, class Estimator>
+inline auto bootstrap(
+    const std::vector<T> &samples,
+    const Estimator &estimator,
+    const bootstrap_options_t &options = bootstrap_options_t()) -> confidence_interval_t<T>
+{
+    if (samples.empty()) {
+        throw std::invalid_argument("Cannot bootstrap an empty set of samples.");
+    }
+    confidence_interval_t<T> interval;
+    interval.estimate   = estimator(samples);
+    interval.confidence = options.confidence;
+    if ((samples.size() < 2) || (options.resamples == 0)) {
+        interval.lower = interval.upper = interval.estimate;
+        return interval;
+    }
+    std::vector<T> estimates(options.resamples);
+    std::size_t threads = detail::bootstrap_threads(options, options.resamples * samples.size());
+    std::vector<std::thread> workers;
+    for (std::size_t t = 1; t < threads; ++t) {
+        workers.emplace_back(
+            detail::bootstrap_blocks<T, Estimator>, std::cref(samples), std::cref(estimator), std::ref(estimates), t,
+            threads, options.seed);
+    }
+    detail::bootstrap_blocks(samples, estimator, estimates, 0, threads, options.seed);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    std::sort(estimates.begin(), estimates.end());
+    double alpha   = (1. - options.confidence) / 2.;
+    interval.lower = timelib::percentile_sorted(estimates, 100. * alpha);
+    interval.upper = timelib::percentile_sorted(estimates, 100. * (1. - alpha));
+    return interval;
+}
+
+/// @brief Computes a bootstrap confidence interval of the mean.
+/// @param samples the samples.
+/// @param options the bootstrap options.
+/// @return the confidence interval.
+template <typename T>
+auto bootstrap_mean(const std::vector<T> &samples, const bootstrap_options_t &options = bootstrap_options_t())
+    -> confidence_interval_t<T>;
+
+/// @brief Computes a bootstrap confidence interval of the median.
+/// @param samples the samples.
+/// @param options the bootstrap options.
+/// @return the confidence interval.
+template <typename T>
+auto bootstrap_median(const std::vector<T> &samples, const bootstrap_options_t &options = bootstrap_options_t())
+    -> confidence_interval_t<T>;
+
+/// @brief The classification of a sample with respect to the Tukey fences.
+enum outlier_t : unsigned char {
+    outlier_low_severe,  ///< Below Q1 - 3 IQR.
+    outlier_low_mild,    ///< Between Q1 - 3 IQR and Q1 - 1.5 IQR.
+    outlier_none,        ///< Between Q1 - 1.5 IQR and Q3 + 1.5 IQR.
+    outlier_high_mild,   ///< Between Q3 + 1.5 IQR and Q3 + 3 IQR.
+    outlier_high_severe  ///< Above Q3 + 3 IQR.
+};
+
+/// @brief The Tukey fences of a set of samples.
+template <typename T>
+struct tukey_fences_t {
+    /// @brief Q1 - 3 IQR.
+    T low_severe;
+    /// @brief Q1 - 1.5 IQR.
+    T low_mild;
+    /// @brief Q3 + 1.5 IQR.
+    T high_mild;
+    /// @brief Q3 + 3 IQR.
+    T high_severe;
+
+    /// @brief Classifies a sample.
+    /// @param value the sample.
+    /// @return the classification of the sample.
+    auto classify(T value) const -> outlier_t
+    {
+        if (value < low_severe) {
+            return outlier_low_severe;
+        }
+        if (value < low_mild) {
+            return outlier_low_mild;
+        }
+        if (value > high_severe) {
+            return outlier_high_severe;
+        }
+        if (value > high_mild) {
+            return outlier_high_mild;
+        }
+        return outlier_none;
+    }
+};
+
+/// @brief The number of samples in each outlier class.
+struct outliers_t {
+    /// @brief Samples below Q1 - 3 IQR.
+    std::size_t low_severe;
+    /// @brief Samples between Q1 - 3 IQR and Q1 - 1.5 IQR.
+    std::size_t low_mild;
+    /// @brief Samples between Q3 + 1.5 IQR and Q3 + 3 IQR.
+    std::size_t high_mild;
+    /// @brief Samples above Q3 + 3 IQR.
+    std::size_t high_severe;
+
+    /// @brief Returns the total number of outliers.
+    /// @return the number of outliers.
+    auto total() const -> std::size_t { return low_severe + low_mild + high_mild + high_severe; }
+};
+
+/// @brief Computes the Tukey fences of the samples.
+/// @param samples the samples.
+/// @return the fences.
+template <typename T>
+auto tukey_fences(std::vector<T> samples) -> tukey_fences_t<T>;
+
+/// @brief Counts the outliers among the samples, using the Tukey fences.
+/// @param samples the samples.
+/// @return the number of samples in each outlier class.
+template <typename T>
+auto classify_outliers(const std::vector<T> &samples) -> outliers_t;
+
+/// @brief A statistical summary of a set of samples.
+template <typename T>
+struct summary_t {
+    /// @brief Number of samples.
+    std::size_t count;
+    /// @brief Smallest sample.
+    T min;
+    /// @brief Largest sample.
+    T max;
+    /// @brief Sample standard deviation.
+    T stddev;
+    /// @brief Median absolute deviation.
+    T mad;
+    /// @brief 5th percentile.
+    T p5;
+    /// @brief 95th percentile.
+    T p95;
+    /// @brief Bootstrap confidence interval of the mean.
+    confidence_interval_t<T> mean;
+    /// @brief Bootstrap confidence interval of the median.
+    confidence_interval_t<T> median;
+    /// @brief Outliers, classified with the Tukey fences.
+    outliers_t outliers;
+
+    /// @brief Converts the summary to a string, interpreting the samples as seconds.
+    /// @return the string representation of the summary.
+    auto to_string() const -> std::string
+    {
+        std::stringstream ss;
+        ss << "samples  : " << count << "\n";
+        ss << "mean     : " << detail::format_time(mean.estimate) << " [" << detail::format_time(mean.lower)
+           << ", " << detail::format_time(mean.upper) << "] @ " << (mean.confidence * 100.) << "%\n";
+        ss << "median   : " << detail::format_time(median.estimate) << " [" << detail::format_time(median.lower)
+           << ", " << detail::format_time(median.upper) << "] @ " << (median.confidence * 100.) << "%\n";
+        ss << "stddev   : " << detail::format_time(stddev) << "\n";
+        ss << "mad      : " << detail::format_time(mad) << "\n";
+        ss << "range    : " << detail::format_time(min) << " .. " << detail::format_time(max) << "\n";
+        ss << "p5..p95  : " << detail::format_time(p5) << " .. " << detail::format_time(p95) << "\n";
+        ss << "outliers : " << outliers.total() << " (" << outliers.low_severe << " low severe, "
+           << outliers.low_mild << " low mild, " << outliers.high_mild << " high mild, " << outliers.high_severe
+           << " high severe)\n";
+        return ss.str();
+    }
+
+    /// @brief Prints the summary to an output stream.
+    /// @param lhs The output stream.
+    /// @param rhs The summary to print.
+    /// @return The modified output stream.
+    friend auto operator<<(std::ostream &lhs, const summary_t &rhs) -> std::ostream &
+    {
+        return (lhs << rhs.to_string());
+    }
+};
+
+/// @brief Computes the statistical summary of a set of samples.
+/// @param samples the samples.
+/// @param options the options of the bootstraps.
+/// @return the summary.
+/// @throw std::invalid_argument if there are no samples.
+template <typename T>
+auto summarize(const std::vector<T> &samples, const bootstrap_options_t &options = bootstrap_options_t())
+    -> summary_t<T>;
+
+/// @brief Computes the statistical summary of the rounds of a stopwatch.
+/// @param stopwatch the stopwatch.
+/// @param options the options of the bootstraps.
+/// @return the summary, in seconds.
+inline auto summarize(const Stopwatch &stopwatch, const bootstrap_options_t &options = bootstrap_options_t())
+    -> summary_t<double>
+{
+    std::vector<double> samples;
+    for (const auto &partial : stopwatch.partials()) {
+        samples.push_back(partial.count());
+    }
+    return timelib::summarize(samples, options);
+}
+
+/// @brief The result of a two-sample hypothesis test.
+struct test_result_t {
+    /// @brief The test statistic (z-score for Mann-Whitney, t for Welch).
+    double statistic;
+    /// @brief The two-sided p-value.
+    double p_value;
+};
+
+namespace detail
+{
+
+/// @brief Evaluates the continued fraction of the regularized incomplete beta function.
+/// @param a the first shape parameter.
+/// @param b the second shape parameter.
+/// @param x the point of evaluation.
+/// @return the value of the continued fraction.
+TIMELIB_INLINE auto incomplete_beta_fraction(double a, double b, double x) -> double;
+
+/// @brief Computes the regularized incomplete beta function I_x(a, b).
+/// @param a the first shape parameter.
+/// @param b the second shape parameter.
+/// @param x the point of evaluation, between 0 and 1.
+/// @return the value of the function.
+TIMELIB_INLINE auto incomplete_beta(double a, double b, double x) -> double;
+
+} // namespace detail
+
+/// @brief Performs the two-sided Mann-Whitney U test, with the normal approximation.
+/// @details Ties receive their average rank, and the variance is corrected for them.
+/// @param a the first set of samples.
+/// @param b the second set of samples.
+/// @return the z-score of the U statistic of the first set, and the p-value.
+/// @throw std::invalid_argument if either set is empty.
+template <typename T>
+auto mann_whitney_u(const std::vector<T> &a, const std::vector<T> &b) -> test_result_t;
+
+/// @brief Performs the two-sided Welch t-test, which does not assume equal variances.
+/// @param a the first set of samples.
+/// @param b the second set of samples.
+/// @return the t statistic of the difference of the means (a - b), and the p-value.
+/// @throw std::invalid_argument if either set has less than two samples.
+template <typename T>
+auto welch_t_test(const std::vector<T> &a, const std::vector<T> &b) -> test_result_t;
+
+namespace detail
+{
+
+/// @brief Computes the quantile of the standard normal distribution, by bisection.
+/// @param probability the cumulative probability, in (0, 1).
+/// @return the value z such that P(Z <= z) equals the probability.
+TIMELIB_INLINE auto normal_quantile(double probability) -> double;
+
+} // namespace detail
+
+/// @brief Computes the difference between the means of two independent sets
+/// of samples, with the propagated uncertainty.
+/// @details The standard errors of the two means are added in quadrature,
+/// and the interval uses the normal approximation.
+/// @param a the first set of samples.
+/// @param b the second set of samples, subtracted from the first.
+/// @param confidence the confidence level of the interval.
+/// @return the difference (a - b), with its confidence interval.
+template <typename T>
+auto difference_of_means(const std::vector<T> &a, const std::vector<T> &b, double confidence = 0.95)
+    -> confidence_interval_t<T>;
+
+/// @brief Lists the instantiations of the statistics for a floating-point
+/// type, which the compiled library provides for double and float.
+/// @details Expanded with `extern` in the headers, which only declare the
+/// templates when the library is compiled, and without it in the library
+/// itself, which defines them and exports the functions (the members of the
+/// structures are all defined inline). The compiled library therefore
+/// provides the statistics for double and float only.
+#define TIMELIB_STATISTICS_INSTANTIATIONS(EXTERN, T)                                                                   \
+    EXTERN template struct confidence_interval_t<T>;                                                                   \
+    EXTERN template struct tukey_fences_t<T>;                                                                          \
+    EXTERN template struct summary_t<T>;                                                                               \
+    EXTERN template TIMELIB_API auto mean<T>(const std::vector<T> &) -> T;                                             \
+    EXTERN template TIMELIB_API auto variance<T>(const std::vector<T> &) -> T;                                         \
+    EXTERN template TIMELIB_API auto stddev<T>(const std::vector<T> &) -> T;                                           \
+    EXTERN template TIMELIB_API auto percentile_sorted<T>(const std::vector<T> &, double) -> T;                        \
+    EXTERN template TIMELIB_API auto percentile<T>(std::vector<T>, double) -> T;                                       \
+    EXTERN template TIMELIB_API auto median<T>(const std::vector<T> &) -> T;                                           \
+    EXTERN template TIMELIB_API auto mad<T>(const std::vector<T> &) -> T;                                              \
+    EXTERN template TIMELIB_API auto bootstrap_mean<T>(const std::vector<T> &, const bootstrap_options_t &)            \
+        -> confidence_interval_t<T>;                                                                                   \
+    EXTERN template TIMELIB_API auto bootstrap_median<T>(const std::vector<T> &, const bootstrap_options_t &)          \
+        -> confidence_interval_t<T>;                                                                                   \
+    EXTERN template TIMELIB_API auto tukey_fences<T>(std::vector<T>) -> tukey_fences_t<T>;                             \
+    EXTERN template TIMELIB_API auto classify_outliers<T>(const std::vector<T> &) -> outliers_t;                       \
+    EXTERN template TIMELIB_API auto summarize<T>(const std::vector<T> &, const bootstrap_options_t &)                 \
+        -> summary_t<T>;                                                                                               \
+    EXTERN template TIMELIB_API auto mann_whitney_u<T>(const std::vector<T> &, const std::vector<T> &)                 \
+        -> test_result_t;                                                                                              \
+    EXTERN template TIMELIB_API auto welch_t_test<T>(const std::vector<T> &, const std::vector<T> &) -> test_result_t; \
+    EXTERN template TIMELIB_API auto difference_of_means<T>(const std::vector<T> &, const std::vector<T> &, double)    \
+        -> confidence_interval_t<T>;
+
+#if defined(TIMELIB_COMPILED_LIB)
+TIMELIB_STATISTICS_INSTANTIATIONS(extern, double)
+TIMELIB_STATISTICS_INSTANTIATIONS(extern, float)
+#endif
+
+} // namespace timelib
+
+#if !defined(TIMELIB_COMPILED_LIB)
+#include "timelib/detail/statistics_impl.hpp"
+#endif
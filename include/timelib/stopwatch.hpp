@@ -9,6 +9,7 @@
 #pragma once
 
 #include "timelib/duration.hpp"
+#include "timelib/optimizer.hpp"
 
 #include <vector>
 
@@ -79,8 +80,10 @@ public:
     {
         // Reset the total duration.
         _total_duration = timespec_t::zero();
-        // Clear all the partials.
+        // Clear all the partials, and the work processed during them.
         _partials.clear();
+        _items.clear();
+        _bytes.clear();
         // Star again the timer.
         this->start();
     }
@@ -101,6 +104,22 @@ public:
         return duration;
     }
 
+    /// @brief Records a round, together with the amount of work processed during it.
+    /// @param items The number of items processed during the round.
+    /// @param bytes The number of bytes processed during the round.
+    /// @return The Duration of the last round.
+    auto round(std::size_t items, std::size_t bytes = 0) -> Duration
+    {
+        Duration duration = this->round();
+        // The work is only tracked from the first round that gives it, so
+        // that the plain rounds do not pay for it.
+        _items.resize(_partials.size() - 1, 0);
+        _bytes.resize(_partials.size() - 1, 0);
+        _items.push_back(items);
+        _bytes.push_back(bytes);
+        return duration;
+    }
+
     /// @brief Returns the duration of the last recorded round.
     /// @return The Duration of the last round.
     auto last_round() const -> Duration
@@ -123,6 +142,14 @@ public:
     /// @return A vector of Duration representing each round.
     auto partials() const -> std::vector<Duration> { return _partials; }
 
+    /// @brief Returns the number of items processed during each round.
+    /// @return A vector with the items of each round (zero when not given).
+    auto items() const -> std::vector<std::size_t> { return this->padded(_items); }
+
+    /// @brief Returns the number of bytes processed during each round.
+    /// @return A vector with the bytes of each round (zero when not given).
+    auto bytes() const -> std::vector<std::size_t> { return this->padded(_bytes); }
+
     /// @brief Converts the Stopwatch's total duration to a string.
     /// @return A string representation of the total duration.
     virtual auto to_string() const -> std::string
@@ -157,30 +184,67 @@ public:
         throw std::out_of_range("Out of range of partial times.");
     }
 
-    /// @brief Prints the Stopwatch's total duration to an output stream.
-    /// @param lhs The output stream.
-    /// @param rhs The Stopwatch to print.
-    /// @return The modified output stream.
-    friend auto operator<<(std::ostream &lhs, const Stopwatch &rhs) -> std::ostream &
+private:
+    /// @brief Pads the work of the rounds with zeros, for the rounds recorded without it.
+    /// @param work the work tracked since the first round that gave it.
+    /// @return a vector with the work of each round.
+    auto padded(const std::vector<std::size_t> &work) const -> std::vector<std::size_t>
     {
-        lhs << rhs.to_string();
-        return lhs;
+        std::vector<std::size_t> result(work);
+        result.resize(_partials.size(), 0);
+        return result;
     }
 
-private:
     /// @brief The time point of the last round or start.
     timespec_t _last_time_point;
     /// @brief The total duration since the Stopwatch started.
     Duration _total_duration;
     /// @brief Stores all partial (round) durations.
     std::vector<Duration> _partials;
+    /// @brief Stores the items processed during each round, from the first one that gave them.
+    std::vector<std::size_t> _items;
+    /// @brief Stores the bytes processed during each round, from the first one that gave them.
+    std::vector<std::size_t> _bytes;
     /// @brief The print mode (e.g., human-readable or numeric).
     print_mode_t _print_mode;
     /// @brief The format string used for printing durations.
     std::string _format;
 };
 
+namespace detail
+{
+
+/// @brief Runs the function a number of times, and samples both the elapsed
+/// time and a tracker of other resources around each call.
+/// @details The tracker (e.g., CounterGroup or ResourceTracker) provides
+/// reset(), start() and round(), like the stopwatch. Both are restarted
+/// before each call, so that reading the tracker is not part of the next round.
+/// @param stopwatch the stopwatch used to retrieve the elapse time.
+/// @param tracker the tracker of the other resources.
+/// @param times the number of calls.
+/// @param function the function to sample.
+/// @return the same stopwatch passed as argument.
+template <class Tracker, class Function>
+inline auto time_tracked(Stopwatch &stopwatch, Tracker &tracker, std::size_t times, const Function &function)
+    -> Stopwatch &
+{
+    tracker.reset();
+    stopwatch.reset();
+    for (std::size_t i = 0U; i < times; ++i) {
+        tracker.start();
+        stopwatch.start();
+        detail::invoke_opaque(function);
+        (void)stopwatch.round();
+        (void)tracker.round();
+    }
+    return stopwatch;
+}
+
+} // namespace detail
+
 /// @brief Runs the function and samples the elapsed time.
+/// @details The result of the function, if any, is kept alive and its writes
+/// are forced to memory, so the measured work cannot be optimized away.
 /// @param stopwatch the stopwatch used to retrieve the elapse time.
 /// @param function the function to sample.
 /// @return the same stopwatch passed as argument.
@@ -188,12 +252,14 @@ template <class Function>
 inline auto time(Stopwatch &stopwatch, const Function &function) -> Stopwatch &
 {
     stopwatch.reset();
-    function();
+    detail::invoke_opaque(function);
     (void)stopwatch.round();
     return stopwatch;
 }
 
 /// @brief Runs the function N times and samples the elapsed time.
+/// @details The result of the function, if any, is kept alive and its writes
+/// are forced to memory, so the measured work cannot be optimized away.
 /// @param stopwatch the stopwatch used to retrieve the elapse time.
 /// @param function the function to sample.
 /// @return the same stopwatch passed as argument.
@@ -202,7 +268,7 @@ inline auto ntimes(Stopwatch &stopwatch, const Function &function) -> Stopwatch
 {
     stopwatch.reset();
     for (std::size_t i = 0U; i < N; ++i) {
-        function();
+        detail::invoke_opaque(function);
         (void)stopwatch.round();
     }
     return stopwatch;
@@ -0,0 +1,352 @@
+/// @file threaded.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the multithreaded benchmark runner, with a barrier-synchronized start and per-thread statistics.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/benchmark.hpp"
+#include "timelib/isolation.hpp"
+
+#include <atomic>
+#include <exception>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace timelib
+{
+
+/// @brief A reusable barrier, whose threads spin (and then yield) instead of
+/// sleeping, so that they are released as close together as possible.
+class SpinBarrier
+{
+public:
+    /// @brief Constructs a SpinBarrier.
+    /// @param count the number of threads taking part in the barrier.
+    /// @throw std::invalid_argument if the count is zero.
+    explicit SpinBarrier(std::size_t count)
+        : _count(count)
+        , _waiting(0)
+        , _generation(0)
+    {
+        if (count == 0) {
+            throw std::invalid_argument("A barrier needs at least one thread.");
+        }
+    }
+
+    /// @brief Returns the number of threads taking part in the barrier.
+    /// @return the number of threads.
+    auto count() const -> std::size_t { return _count; }
+
+    /// @brief Blocks until all the threads have reached the barrier.
+    void wait()
+    {
+        std::size_t generation = _generation.load(std::memory_order_acquire);
+        if (_waiting.fetch_add(1, std::memory_order_acq_rel) == (_count - 1)) {
+            _waiting.store(0, std::memory_order_relaxed);
+            _generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        // Spin for a while, then give the processor away, so that the barrier
+        // does not starve the other threads when the machine is oversubscribed.
+        for (std::size_t spins = 0; _generation.load(std::memory_order_acquire) == generation; ++spins) {
+            if (spins > 1024) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    /// @brief The number of threads taking part in the barrier.
+    const std::size_t _count;
+    /// @brief The number of threads currently waiting.
+    std::atomic<std::size_t> _waiting;
+    /// @brief Incremented every time the barrier releases its threads.
+    std::atomic<std::size_t> _generation;
+};
+
+/// @brief The options of a multithreaded benchmark run.
+struct threaded_options_t {
+    /// @brief Constructs the default options.
+    threaded_options_t()
+        : benchmark()
+        , pin(false)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Warmup, target time and number of repetitions of each thread.
+    benchmark_options_t benchmark;
+    /// @brief Pins the i-th thread to the i-th processor (modulo the number of processors).
+    bool pin;
+};
+
+/// @brief The results of a multithreaded benchmark run, with a fixed number of threads.
+struct threaded_result_t {
+    /// @brief The name of the benchmark.
+    std::string name;
+    /// @brief The number of threads.
+    std::size_t threads;
+    /// @brief The repetitions measured by each thread.
+    std::vector<benchmark_result_t> per_thread;
+    /// @brief The repetitions of all threads together, from the release of
+    /// the barrier to the end of the slowest thread.
+    benchmark_result_t aggregate;
+
+    /// @brief Returns the throughput of a thread, across all its repetitions.
+    /// @param thread the index of the thread.
+    /// @return the iterations per second.
+    auto thread_throughput(std::size_t thread) const -> double
+    {
+        double iterations = 0.;
+        double elapsed    = 0.;
+        for (const auto &repetition : per_thread.at(thread).repetitions) {
+            iterations += static_cast<double>(repetition.iterations);
+            elapsed += repetition.elapsed.count();
+        }
+        return (elapsed > 0.) ? (iterations / elapsed) : 0.;
+    }
+
+    /// @brief Returns the median throughput of all the threads together.
+    /// @return the iterations per second.
+    auto throughput() const -> double
+    {
+        std::vector<double> values;
+        for (const auto &repetition : aggregate.repetitions) {
+            values.push_back(repetition.iterations_per_second());
+        }
+        return values.empty() ? 0. : timelib::median(values);
+    }
+
+    /// @brief Returns the Jain's fairness index of the per-thread throughputs.
+    /// @details The index is one when all the threads progress at the same
+    /// rate, and tends to 1/N when a single thread does all the work.
+    /// @return the fairness index, between 1/N and 1.
+    auto fairness() const -> double
+    {
+        double sum    = 0.;
+        double sum_sq = 0.;
+        for (std::size_t i = 0; i < per_thread.size(); ++i) {
+            double value = this->thread_throughput(i);
+            sum += value;
+            sum_sq += value * value;
+        }
+        return (sum_sq > 0.) ? ((sum * sum) / (static_cast<double>(per_thread.size()) * sum_sq)) : 0.;
+    }
+
+    /// @brief Converts the results to a table, with a row for each thread.
+    /// @return the string representation of the results.
+    auto to_string() const -> std::string
+    {
+        std::stringstream ss;
+        ss << std::left << std::setw(32) << (name + " (" + std::to_string(threads) + " threads)") << std::right
+           << std::setw(14) << "time/iter" << std::setw(16) << "iter/s"
+           << "\n";
+        for (std::size_t i = 0; i < per_thread.size(); ++i) {
+            ss << std::left << std::setw(32) << ("  thread #" + std::to_string(i)) << std::right << std::setw(14)
+               << detail::format_time(timelib::median(per_thread[i].samples())) << std::setw(16) << std::fixed
+               << std::setprecision(1) << this->thread_throughput(i) << "\n";
+        }
+        ss << std::left << std::setw(32) << "  aggregate" << std::right << std::setw(30) << std::fixed
+           << std::setprecision(1) << this->throughput() << "\n";
+        ss << std::left << std::setw(32) << "  fairness" << std::right << std::setw(30) << std::setprecision(3)
+           << this->fairness() << "\n";
+        return ss.str();
+    }
+
+    /// @brief Prints the results to an output stream.
+    /// @param lhs The output stream.
+    /// @param rhs The results to print.
+    /// @return The modified output stream.
+    friend auto operator<<(std::ostream &lhs, const threaded_result_t &rhs) -> std::ostream &
+    {
+        return (lhs << rhs.to_string());
+    }
+};
+
+/// @brief The results of a multithreaded benchmark across several thread counts.
+struct scaling_result_t {
+    /// @brief The name of the benchmark.
+    std::string name;
+    /// @brief The results for each thread count.
+    std::vector<threaded_result_t> runs;
+
+    /// @brief Returns the speedup of a run, with respect to the first one.
+    /// @param run the index of the run.
+    /// @return the ratio between the aggregate throughputs.
+    auto speedup(std::size_t run) const -> double
+    {
+        double reference = runs.at(0).throughput();
+        return (reference > 0.) ? (runs.at(run).throughput() / reference) : 0.;
+    }
+
+    /// @brief Returns the scaling efficiency of a run, with respect to the first one.
+    /// @details The efficiency is the speedup divided by the increase in
+    /// threads: one means perfect linear scaling.
+    /// @param run the index of the run.
+    /// @return the scaling efficiency.
+    auto efficiency(std::size_t run) const -> double
+    {
+        double ratio = static_cast<double>(runs.at(run).threads) / static_cast<double>(runs.at(0).threads);
+        return this->speedup(run) / ratio;
+    }
+
+    /// @brief Converts the results to a table, with a row for each thread count.
+    /// @return the string representation of the results.
+    auto to_string() const -> std::string
+    {
+        std::stringstream ss;
+        ss << std::left << std::setw(32) << name << std::right << std::setw(16) << "iter/s" << std::setw(10)
+           << "speedup" << std::setw(12) << "efficiency" << std::setw(10) << "fairness"
+           << "\n";
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            ss << std::left << std::setw(32) << ("  " + std::to_string(runs[i].threads) + " threads") << std::right
+               << std::fixed << std::setprecision(1) << std::setw(16) << runs[i].throughput() << std::setprecision(2)
+               << std::setw(10) << this->speedup(i) << std::setw(12) << this->efficiency(i) << std::setprecision(3)
+               << std::setw(10) << runs[i].fairness() << "\n";
+        }
+        return ss.str();
+    }
+
+    /// @brief Prints the results to an output stream.
+    /// @param lhs The output stream.
+    /// @param rhs The results to print.
+    /// @return The modified output stream.
+    friend auto operator<<(std::ostream &lhs, const scaling_result_t &rhs) -> std::ostream &
+    {
+        return (lhs << rhs.to_string());
+    }
+};
+
+/// @brief A benchmark runner that executes the same function on several
+/// threads at once, to measure contention and scaling.
+/// @details The number of iterations is calibrated on a single thread. Then,
+/// for each repetition, all the threads are released together by a spin
+/// barrier, and each thread times its own iterations.
+class ThreadedBenchmark
+{
+public:
+    /// @brief Constructs a ThreadedBenchmark.
+    /// @param name the name of the benchmark.
+    /// @param options the options of the run.
+    explicit ThreadedBenchmark(std::string name, threaded_options_t options = threaded_options_t())
+        : _name(std::move(name))
+        , _options(options)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the name of the benchmark.
+    /// @return the name.
+    auto name() const -> const std::string & { return _name; }
+
+    /// @brief Returns the options of the benchmark.
+    /// @return a reference to the options.
+    auto options() -> threaded_options_t & { return _options; }
+
+    /// @brief Runs the benchmark on the given number of threads.
+    /// @param function the function to benchmark, which must be thread-safe.
+    /// @param threads the number of threads.
+    /// @return the results of the run.
+    /// @throw std::invalid_argument if the number of threads is zero.
+    template <class Function>
+    auto run(const Function &function, std::size_t threads) -> threaded_result_t
+    {
+        if (threads == 0) {
+            throw std::invalid_argument("A threaded benchmark needs at least one thread.");
+        }
+        Benchmark benchmark(_name, _options.benchmark);
+        benchmark.warmup(function);
+        std::size_t iterations = benchmark.calibrate(function);
+
+        threaded_result_t result;
+        result.name    = _name;
+        result.threads = threads;
+        result.per_thread.resize(threads);
+        result.aggregate.name                = _name + "/" + std::to_string(threads);
+        result.aggregate.items_per_iteration = _options.benchmark.items_per_iteration;
+        result.aggregate.bytes_per_iteration = _options.benchmark.bytes_per_iteration;
+        for (std::size_t i = 0; i < threads; ++i) {
+            result.per_thread[i].name                = result.aggregate.name + "/#" + std::to_string(i);
+            result.per_thread[i].items_per_iteration = _options.benchmark.items_per_iteration;
+            result.per_thread[i].bytes_per_iteration = _options.benchmark.bytes_per_iteration;
+        }
+
+        // The main thread takes part in the barriers too, to measure the time
+        // between the release of the threads and the end of the slowest one.
+        SpinBarrier barrier(threads + 1);
+        std::vector<std::exception_ptr> errors(threads);
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) {
+            workers.emplace_back([&, i]() {
+                if (_options.pin) {
+                    (void)timelib::pin_current_thread(i % std::max(std::thread::hardware_concurrency(), 1U));
+                }
+                for (std::size_t r = 0; r < _options.benchmark.repetitions; ++r) {
+                    barrier.wait();
+                    repetition_t repetition;
+                    repetition.iterations = iterations;
+                    if (!errors[i]) {
+                        try {
+                            Benchmark::measure(function, repetition);
+                        } catch (...) {
+                            errors[i] = std::current_exception();
+                        }
+                    }
+                    result.per_thread[i].repetitions.push_back(repetition);
+                    barrier.wait();
+                }
+            });
+        }
+        for (std::size_t r = 0; r < _options.benchmark.repetitions; ++r) {
+            barrier.wait();
+            timespec_t start = timespec_t::now();
+            barrier.wait();
+            repetition_t repetition;
+            repetition.iterations = iterations * threads;
+            repetition.elapsed    = timespec_t::now() - start;
+            result.aggregate.repetitions.push_back(repetition);
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        for (const auto &error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        return result;
+    }
+
+    /// @brief Runs the benchmark for each of the given thread counts.
+    /// @param function the function to benchmark, which must be thread-safe.
+    /// @param thread_counts the thread counts, the first one being the reference for the scaling.
+    /// @return the results of the runs.
+    template <class Function>
+    auto scale(const Function &function, const std::vector<std::size_t> &thread_counts) -> scaling_result_t
+    {
+        scaling_result_t result;
+        result.name = _name;
+        for (std::size_t threads : thread_counts) {
+            result.runs.push_back(this->run(function, threads));
+        }
+        return result;
+    }
+
+private:
+    /// @brief The name of the benchmark.
+    std::string _name;
+    /// @brief The options of the run.
+    threaded_options_t _options;
+};
+
+} // namespace timelib
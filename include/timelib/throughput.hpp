@@ -0,0 +1,140 @@
+/// @file throughput.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the throughput (items per second, bytes per second) of measured rounds.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/statistics.hpp"
+#include "timelib/stopwatch.hpp"
+
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace timelib
+{
+
+/// @brief The unit of a throughput.
+enum throughput_unit_t : unsigned char {
+    unit_items, ///< Items per second.
+    unit_bytes  ///< Bytes per second.
+};
+
+namespace detail
+{
+
+/// @brief Formats a rate, scaling it to the most readable decimal prefix.
+/// @param rate the rate, per second.
+/// @param unit the unit of the rate.
+/// @return the formatted string (e.g., "1.25 GB/s" or "3.10 M items/s").
+inline auto format_rate(double rate, throughput_unit_t unit) -> std::string
+{
+    static const char *prefixes[] = {"", "k", "M", "G", "T", "P"};
+    std::size_t prefix            = 0;
+    double magnitude              = (rate < 0.) ? -rate : rate;
+    while ((magnitude >= 1000.) && (prefix < 5)) {
+        magnitude /= 1000.;
+        rate /= 1000.;
+        ++prefix;
+    }
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2) << rate << " ";
+    if (unit == unit_bytes) {
+        ss << prefixes[prefix] << "B/s";
+    } else {
+        ss << prefixes[prefix] << ((prefix > 0) ? " " : "") << "items/s";
+    }
+    return ss.str();
+}
+
+} // namespace detail
+
+/// @brief The throughput of a set of rounds.
+struct throughput_t {
+    /// @brief The unit of the throughput.
+    throughput_unit_t unit;
+    /// @brief The total amount processed, divided by the total time.
+    double aggregate;
+    /// @brief The rate of each round.
+    std::vector<double> rates;
+    /// @brief The bootstrap confidence interval of the mean rate.
+    confidence_interval_t<double> interval;
+
+    /// @brief Converts the throughput to a string.
+    /// @return the string representation of the throughput.
+    auto to_string() const -> std::string
+    {
+        std::stringstream ss;
+        ss << detail::format_rate(aggregate, unit) << " [" << detail::format_rate(interval.lower, unit) << ", "
+           << detail::format_rate(interval.upper, unit) << "] @ " << std::fixed << std::setprecision(0)
+           << (interval.confidence * 100.) << "%";
+        return ss.str();
+    }
+
+    /// @brief Prints the throughput to an output stream.
+    /// @param lhs The output stream.
+    /// @param rhs The throughput to print.
+    /// @return The modified output stream.
+    friend auto operator<<(std::ostream &lhs, const throughput_t &rhs) -> std::ostream &
+    {
+        return (lhs << rhs.to_string());
+    }
+};
+
+/// @brief Computes the throughput of a set of rounds.
+/// @param amounts the amount processed during each round.
+/// @param seconds the duration of each round, in seconds.
+/// @param unit the unit of the amounts.
+/// @param options the options of the bootstrap of the mean rate.
+/// @return the throughput.
+/// @throw std::invalid_argument if the vectors have different sizes.
+inline auto compute_throughput(
+    const std::vector<double> &amounts,
+    const std::vector<double> &seconds,
+    throughput_unit_t unit,
+    const bootstrap_options_t &options = bootstrap_options_t()) -> throughput_t
+{
+    if (amounts.size() != seconds.size()) {
+        throw std::invalid_argument("The throughput needs a duration for each amount.");
+    }
+    throughput_t result;
+    result.unit    = unit;
+    double total   = 0.;
+    double elapsed = 0.;
+    for (std::size_t i = 0; i < amounts.size(); ++i) {
+        total += amounts[i];
+        elapsed += seconds[i];
+        result.rates.push_back((seconds[i] > 0.) ? (amounts[i] / seconds[i]) : 0.);
+    }
+    result.aggregate = (elapsed > 0.) ? (total / elapsed) : 0.;
+    result.interval  = timelib::bootstrap_mean(result.rates, options);
+    return result;
+}
+
+/// @brief Computes the throughput of the rounds of a stopwatch, recorded with Stopwatch::round(items, bytes).
+/// @param stopwatch the stopwatch.
+/// @param unit selects either the items or the bytes of the rounds.
+/// @param options the options of the bootstrap of the mean rate.
+/// @return the throughput.
+inline auto compute_throughput(
+    const Stopwatch &stopwatch,
+    throughput_unit_t unit,
+    const bootstrap_options_t &options = bootstrap_options_t()) -> throughput_t
+{
+    std::vector<std::size_t> counts = (unit == unit_bytes) ? stopwatch.bytes() : stopwatch.items();
+    std::vector<double> amounts;
+    std::vector<double> seconds;
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        amounts.push_back(static_cast<double>(counts[i]));
+        seconds.push_back(stopwatch[i].count());
+    }
+    return compute_throughput(amounts, seconds, unit, options);
+}
+
+} // namespace timelib
@@ -103,16 +103,6 @@ public:
     /// @return A string representation of the total duration.
     auto to_string() const -> std::string { return this->elapsed().to_string(); }
 
-    /// @brief Prints the Timer's total duration to an output stream.
-    /// @param lhs The output stream.
-    /// @param rhs The Timer to print.
-    /// @return The modified output stream.
-    friend auto operator<<(std::ostream &lhs, const Timer &rhs) -> std::ostream &
-    {
-        lhs << rhs.elapsed().to_string();
-        return lhs;
-    }
-
 private:
     /// @brief Returns the total elapsed time without resetting the Timer.
     /// @return The total elapsed Duration.
@@ -9,8 +9,7 @@
 #pragma once
 
 #include <ctime>
-#include <iomanip>
-#include <iostream>
+#include <stdexcept>
 #include <type_traits>
 
 namespace timelib
@@ -223,6 +222,30 @@ public:
         return ts;
     }
 
+    /// @brief Returns the name of the clock read by now().
+    /// @return the name of the clock.
+    static auto clock_name() -> const char *
+    {
+#ifdef _WIN32
+        return "timespec_get(TIME_UTC)";
+#else
+        return "CLOCK_REALTIME";
+#endif
+    }
+
+    /// @brief Returns the resolution of the clock read by now().
+    /// @return the resolution, or zero if it is not known.
+    static auto resolution() -> timespec_t
+    {
+        timespec_t ts;
+#ifndef _WIN32
+        if (clock_getres(CLOCK_REALTIME, &ts) != 0) {
+            return timespec_t();
+        }
+#endif
+        return ts;
+    }
+
     /// @brief Returns a zero timespec_t object.
     /// @return A timespec_t object representing zero time.
     static auto zero() -> timespec_t
@@ -665,16 +688,6 @@ public:
     {
         return !(timespec_t(lhs) < rhs);
     }
-
-    /// @brief Output stream operator to print timespec_t.
-    /// @param os The output stream.
-    /// @param ts The timespec_t instance.
-    /// @return Reference to the output stream.
-    friend auto operator<<(std::ostream &os, const timespec_t &ts) -> std::ostream &
-    {
-        os << "<s: " << ts.tv_sec << ", ns: " << ts.tv_nsec << ">";
-        return os;
-    }
 };
 
 } // namespace timelib
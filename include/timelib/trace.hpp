@@ -0,0 +1,413 @@
+/// @file trace.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the tracing of events in per-thread buffers, flushed in batches to a global sink.
+///
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+
+#pragma once
+
+#include "timelib/instrument.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if !defined(TIMELIB_TRACE_BUFFER_SIZE)
+/// @brief The number of events held by the buffer of each thread, before
+/// it is flushed to the sink (16 bytes per event).
+#define TIMELIB_TRACE_BUFFER_SIZE 1024
+#endif
+
+/// @brief Traces the rest of the enclosing scope, as a begin and an end event with the given name.
+/// @details Usage:
+///     TIMELIB_TRACE_SCOPE(TIMELIB_LEVEL_FINE, "solve");
+/// Expands to nothing if the level is above TIMELIB_LEVEL, see instrument.hpp.
+#define TIMELIB_TRACE_SCOPE(level, name)                                                                               \
+    TIMELIB_CONCAT(TIMELIB_TRACE_SCOPE_, TIMELIB_CONCAT(TIMELIB_LEVEL_ENABLED_, level))(name)
+
+/// @brief The traced scope of a level that is compiled in.
+#define TIMELIB_TRACE_SCOPE_1(name)                                                                                    \
+    static const std::uint32_t TIMELIB_CONCAT(timelib_trace_id_, __LINE__) = timelib::register_trace_name(name);      \
+    const timelib::TraceScope TIMELIB_CONCAT(timelib_traced_, __LINE__)(TIMELIB_CONCAT(timelib_trace_id_, __LINE__))
+
+/// @brief The traced scope of a level that is compiled out.
+#define TIMELIB_TRACE_SCOPE_0(name)
+
+namespace timelib
+{
+
+/// @brief The phase of a traced event.
+enum trace_phase_t : unsigned char {
+    trace_begin_phase,  ///< The beginning of a scope.
+    trace_end_phase,    ///< The end of a scope.
+    trace_instant_phase ///< An event without duration.
+};
+
+/// @brief An event, as recorded in the buffer of a thread.
+/// @details The event takes 16 bytes, so that four of them fit in a cache line.
+struct trace_event_t {
+    /// @brief When the event happened, in nanoseconds since the epoch of timespec_t::now().
+    std::uint64_t timestamp;
+    /// @brief The identifier of the event, see register_trace_name().
+    std::uint32_t id;
+    /// @brief The index of the thread, in order of first event (modulo 65536).
+    std::uint16_t thread;
+    /// @brief The phase of the event.
+    trace_phase_t phase;
+};
+
+/// @brief The destination of the events, receiving them in batches.
+/// @details The calls are serialized by the tracer, so a sink does not need
+/// to be thread-safe with respect to itself.
+class TraceSink
+{
+public:
+    /// @brief Constructs a TraceSink.
+    TraceSink() = default;
+
+    /// @brief Copy constructor, deleted, since the tracer refers to the sink.
+    /// @param other The other entity to copy.
+    TraceSink(const TraceSink &other) = delete;
+
+    /// @brief Copy assignment operator, deleted, since the tracer refers to the sink.
+    /// @param other The other entity to copy.
+    /// @return A reference to this object.
+    auto operator=(const TraceSink &other) -> TraceSink & = delete;
+
+    /// @brief Virtual destructor.
+    virtual ~TraceSink() = default;
+
+    /// @brief Receives a batch of events, all from the same thread, in chronological order.
+    /// @param events the events.
+    /// @param count the number of events.
+    virtual void consume(const trace_event_t *events, std::size_t count) = 0;
+
+    /// @brief Completes the pending output (e.g., flushes a file), called by trace_drain().
+    virtual void flush()
+    {
+        // Nothing to do.
+    }
+};
+
+class TraceBuffer;
+
+namespace detail
+{
+
+/// @brief The global state of the tracer.
+struct trace_state_t {
+    /// @brief Constructs the state, without a sink.
+    trace_state_t()
+        : mutex()
+        , sink(nullptr)
+        , buffers()
+        , next_thread(0)
+        , names()
+        , names_mutex()
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Serializes the flushes, and protects the rest of the state.
+    std::mutex mutex;
+    /// @brief The sink receiving the events, nullptr to discard them.
+    TraceSink *sink;
+    /// @brief The buffers of the threads that have recorded an event and are still running.
+    std::vector<TraceBuffer *> buffers;
+    /// @brief The index of the next thread recording its first event.
+    std::uint16_t next_thread;
+    /// @brief The names of the events, indexed by their identifier.
+    std::vector<std::string> names;
+    /// @brief Protects the names, which are looked up while flushing.
+    std::mutex names_mutex;
+};
+
+/// @brief Returns the global state of the tracer.
+/// @details It is built before the first buffer, and is therefore destroyed
+/// after the buffers of all the threads (the main one included).
+/// @return a reference to the state.
+inline auto trace_state() -> trace_state_t &
+{
+    static trace_state_t state;
+    return state;
+}
+
+/// @brief Returns the current time, in nanoseconds.
+/// @return the nanoseconds since the epoch of timespec_t::now().
+inline auto trace_clock() -> std::uint64_t
+{
+    timespec_t now = timespec_t::now();
+    return (static_cast<std::uint64_t>(now.tv_sec) * 1000000000ULL) + static_cast<std::uint64_t>(now.tv_nsec);
+}
+
+} // namespace detail
+
+/// @brief The buffer of a thread, recording its events without any
+/// synchronization, and flushing them to the sink when it is full, when the
+/// thread exits, and when trace_drain() is called.
+/// @details The buffer is aligned to a cache line, so that the buffers of
+/// different threads never share one.
+class alignas(64) TraceBuffer
+{
+public:
+    /// @brief The number of events held by the buffer.
+    static const std::size_t capacity = TIMELIB_TRACE_BUFFER_SIZE;
+
+    /// @brief Constructs the buffer of the calling thread, and registers it for trace_drain().
+    TraceBuffer()
+        : _size(0)
+        , _thread(0)
+        , _events()
+    {
+        detail::trace_state_t &state = detail::trace_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        _thread = state.next_thread++;
+        state.buffers.push_back(this);
+    }
+
+    /// @brief Copy constructor, deleted, since the tracer refers to the buffer.
+    /// @param other The other entity to copy.
+    TraceBuffer(const TraceBuffer &other) = delete;
+
+    /// @brief Copy assignment operator, deleted, since the tracer refers to the buffer.
+    /// @param other The other entity to copy.
+    /// @return A reference to this object.
+    auto operator=(const TraceBuffer &other) -> TraceBuffer & = delete;
+
+    /// @brief Flushes the remaining events, when the thread exits, and unregisters the buffer.
+    ~TraceBuffer()
+    {
+        detail::trace_state_t &state = detail::trace_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        this->flush_locked(state);
+        state.buffers.erase(std::remove(state.buffers.begin(), state.buffers.end(), this), state.buffers.end());
+    }
+
+    /// @brief Records an event, flushing the buffer first if it is full.
+    /// @param id the identifier of the event.
+    /// @param phase the phase of the event.
+    void record(std::uint32_t id, trace_phase_t phase)
+    {
+        if (_size == capacity) {
+            this->flush();
+        }
+        trace_event_t &event = _events[_size++];
+        event.timestamp      = detail::trace_clock();
+        event.id             = id;
+        event.thread         = _thread;
+        event.phase          = phase;
+    }
+
+    /// @brief Sends the recorded events to the sink, as a single batch.
+    void flush()
+    {
+        detail::trace_state_t &state = detail::trace_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        this->flush_locked(state);
+    }
+
+    /// @brief Sends the recorded events to the sink, with the lock of the tracer already held.
+    /// @param state the global state of the tracer.
+    void flush_locked(detail::trace_state_t &state)
+    {
+        if ((_size > 0) && (state.sink != nullptr)) {
+            state.sink->consume(_events, _size);
+        }
+        _size = 0;
+    }
+
+    /// @brief Returns the number of events waiting to be flushed.
+    /// @return the number of events.
+    auto size() const -> std::size_t { return _size; }
+
+private:
+    /// @brief The number of events recorded since the last flush.
+    std::size_t _size;
+    /// @brief The index of the thread owning the buffer.
+    std::uint16_t _thread;
+    /// @brief The events recorded since the last flush.
+    trace_event_t _events[TIMELIB_TRACE_BUFFER_SIZE];
+};
+
+/// @brief Returns the buffer of the calling thread, built on its first event.
+/// @return a reference to the buffer.
+inline auto trace_buffer() -> TraceBuffer &
+{
+    static thread_local TraceBuffer buffer;
+    return buffer;
+}
+
+/// @brief Sets the sink receiving the events.
+/// @details The events recorded while there is no sink are discarded when
+/// flushed. Call trace_drain() before replacing or destroying a sink, so
+/// that it receives all of its events.
+/// @param sink the sink, nullptr to discard the events.
+inline void set_trace_sink(TraceSink *sink)
+{
+    detail::trace_state_t &state = detail::trace_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.sink = sink;
+}
+
+/// @brief Flushes the buffers of all the running threads to the sink, and then flushes the sink.
+/// @details Meant for shutdown: the buffers of the other threads are read
+/// without synchronization, so they must not record events while draining
+/// (the threads that have exited have already flushed theirs).
+inline void trace_drain()
+{
+    detail::trace_state_t &state = detail::trace_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (TraceBuffer *buffer : state.buffers) {
+        buffer->flush_locked(state);
+    }
+    if (state.sink != nullptr) {
+        state.sink->flush();
+    }
+}
+
+/// @brief Returns the identifier of an event name, registering it on first use.
+/// @details Registering takes a lock, so call sites should keep the
+/// identifier in a static variable, as TIMELIB_TRACE_SCOPE does.
+/// @param name the name of the event.
+/// @return the identifier.
+inline auto register_trace_name(const std::string &name) -> std::uint32_t
+{
+    detail::trace_state_t &state = detail::trace_state();
+    std::lock_guard<std::mutex> lock(state.names_mutex);
+    for (std::size_t i = 0; i < state.names.size(); ++i) {
+        if (state.names[i] == name) {
+            return static_cast<std::uint32_t>(i);
+        }
+    }
+    state.names.push_back(name);
+    return static_cast<std::uint32_t>(state.names.size() - 1);
+}
+
+/// @brief Returns the name of an event.
+/// @param id the identifier of the event.
+/// @return the name, or the identifier as text if it was not registered by name.
+inline auto trace_name(std::uint32_t id) -> std::string
+{
+    detail::trace_state_t &state = detail::trace_state();
+    std::lock_guard<std::mutex> lock(state.names_mutex);
+    return (id < state.names.size()) ? state.names[id] : std::to_string(id);
+}
+
+/// @brief Records the beginning of a scope, in the buffer of the calling thread.
+/// @param id the identifier of the event.
+inline void trace_begin(std::uint32_t id) { trace_buffer().record(id, trace_begin_phase); }
+
+/// @brief Records the end of a scope, in the buffer of the calling thread.
+/// @param id the identifier of the event.
+inline void trace_end(std::uint32_t id) { trace_buffer().record(id, trace_end_phase); }
+
+/// @brief Records an event without duration, in the buffer of the calling thread.
+/// @param id the identifier of the event.
+inline void trace_instant(std::uint32_t id) { trace_buffer().record(id, trace_instant_phase); }
+
+/// @brief Records the beginning of a scope when constructed, and its end when destroyed.
+class TraceScope
+{
+public:
+    /// @brief Records the beginning of the scope.
+    /// @param id the identifier of the event.
+    explicit TraceScope(std::uint32_t id)
+        : _id(id)
+    {
+        trace_begin(_id);
+    }
+
+    /// @brief Copy constructor, deleted, since the scope can be traced only once.
+    /// @param other The other entity to copy.
+    TraceScope(const TraceScope &other) = delete;
+
+    /// @brief Copy assignment operator, deleted, since the scope can be traced only once.
+    /// @param other The other entity to copy.
+    /// @return A reference to this object.
+    auto operator=(const TraceScope &other) -> TraceScope & = delete;
+
+    /// @brief Records the end of the scope.
+    ~TraceScope() { trace_end(_id); }
+
+private:
+    /// @brief The identifier of the event.
+    std::uint32_t _id;
+};
+
+/// @brief A sink keeping the events in memory, in the order they are flushed.
+class TraceQueue : public TraceSink
+{
+public:
+    /// @brief Appends a batch of events to the queue.
+    /// @param events the events.
+    /// @param count the number of events.
+    void consume(const trace_event_t *events, std::size_t count) override
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _events.insert(_events.end(), events, events + count);
+    }
+
+    /// @brief Removes the events received so far from the queue.
+    /// @return the events, grouped by batch.
+    auto take() -> std::vector<trace_event_t>
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::vector<trace_event_t> result;
+        result.swap(_events);
+        return result;
+    }
+
+private:
+    /// @brief Protects the events from the threads taking them.
+    std::mutex _mutex;
+    /// @brief The events received, and not taken yet.
+    std::vector<trace_event_t> _events;
+};
+
+/// @brief A sink writing the events to a CSV file, with a line per event.
+class TraceFile : public TraceSink
+{
+public:
+    /// @brief Creates the file, and writes the header.
+    /// @param path the path of the file.
+    /// @throw std::runtime_error if the file cannot be created.
+    explicit TraceFile(const std::string &path)
+        : _file(std::fopen(path.c_str(), "w"))
+    {
+        if (_file == nullptr) {
+            throw std::runtime_error("Cannot create the trace file '" + path + "'.");
+        }
+        std::fputs("timestamp_ns,thread,phase,name\n", _file);
+    }
+
+    /// @brief Closes the file.
+    ~TraceFile() override { std::fclose(_file); }
+
+    /// @brief Writes a batch of events.
+    /// @param events the events.
+    /// @param count the number of events.
+    void consume(const trace_event_t *events, std::size_t count) override
+    {
+        static const char *const phases[] = {"begin", "end", "instant"};
+        for (std::size_t i = 0; i < count; ++i) {
+            std::fprintf(
+                _file, "%llu,%u,%s,%s\n", static_cast<unsigned long long>(events[i].timestamp),
+                static_cast<unsigned>(events[i].thread), phases[events[i].phase], trace_name(events[i].id).c_str());
+        }
+    }
+
+    /// @brief Flushes the file.
+    void flush() override { std::fflush(_file); }
+
+private:
+    /// @brief The file.
+    std::FILE *_file;
+};
+
+} // namespace timelib
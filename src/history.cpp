@@ -0,0 +1,9 @@
+/// @file history.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Compiles the storage, the change-point detection and the charts of the benchmark history.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/history.hpp"
+
+#include "timelib/detail/history_impl.hpp"
@@ -0,0 +1,9 @@
+/// @file json.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Compiles the writer and the parser of the JSON values.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/json.hpp"
+
+#include "timelib/detail/json_impl.hpp"
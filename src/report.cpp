@@ -0,0 +1,9 @@
+/// @file report.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Compiles the environment probes, the report files and the comparison against a baseline.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/report.hpp"
+
+#include "timelib/detail/report_impl.hpp"
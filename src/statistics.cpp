@@ -0,0 +1,17 @@
+/// @file statistics.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Compiles the numerical functions of the statistics, and their instantiations for double and float.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/statistics.hpp"
+
+#include "timelib/detail/statistics_impl.hpp"
+
+namespace timelib
+{
+
+TIMELIB_STATISTICS_INSTANTIATIONS(, double)
+TIMELIB_STATISTICS_INSTANTIATIONS(, float)
+
+} // namespace timelib
@@ -0,0 +1,25 @@
+# Compares the code (the disassembly of the .text section) of two objects,
+# and fails if it differs. Usage:
+#   cmake -DOBJDUMP=<objdump> -DFIRST=<object> -DSECOND=<object> -P compare_objects.cmake
+
+foreach(object FIRST SECOND)
+    execute_process(
+        COMMAND ${OBJDUMP} -d --section=.text ${${object}}
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE error
+    )
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Cannot disassemble '${${object}}': ${error}")
+    endif()
+    # The header names the object, which is the only expected difference.
+    string(REPLACE "${${object}}" "<object>" output "${output}")
+    set(${object}_CODE "${output}")
+endforeach()
+
+if(NOT FIRST_CODE STREQUAL SECOND_CODE)
+    message(FATAL_ERROR "The code of the objects differs.\n"
+        "${FIRST}:\n${FIRST_CODE}\n"
+        "${SECOND}:\n${SECOND_CODE}")
+endif()
+message(STATUS "The code of the objects is identical.")
@@ -0,0 +1,30 @@
+/// @file test_counters.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Checks that the software counters see the events happening in the kernel.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/counters.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+int main(int, char *[])
+{
+    timelib::CounterGroup counters(std::vector<timelib::counter_event_t>{timelib::event_context_switches});
+    if (!counters.available(timelib::event_context_switches)) {
+        std::cout << "Skipped: the context switches cannot be counted on this system.\n";
+        return 77;
+    }
+    // Every sleep gives up the processor, so it is at least a context switch.
+    timelib::Stopwatch stopwatch;
+    timelib::time(stopwatch, counters, [] {
+        for (int i = 0; i < 20; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    double switches = counters.rounds().back().values[timelib::event_context_switches];
+    std::cout << "context-switches=" << switches << " over 20 sleeps\n";
+    return (switches > 0.) ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+/// @file test_instrument_off.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Instrumented functions, built at TIMELIB_LEVEL 0 once with the
+/// macros and once with the macros stubbed out (TIMELIB_TEST_STUBBED), so
+/// that the code of the two objects can be compared.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+
+#include "timelib/instrument.hpp"
+#include "timelib/trace.hpp"
+
+#include <cstddef>
+#include <vector>
+
+#if defined(TIMELIB_TEST_STUBBED)
+#undef TIMELIB_SCOPED_TIMER
+#undef TIMELIB_ZONE
+#undef TIMELIB_COUNTER
+#undef TIMELIB_TRACE_SCOPE
+#define TIMELIB_SCOPED_TIMER(level, name)
+#define TIMELIB_ZONE(level)
+#define TIMELIB_COUNTER(level, name, value)
+#define TIMELIB_TRACE_SCOPE(level, name)
+#endif
+
+auto test_is_prime(std::size_t value) -> bool
+{
+    TIMELIB_ZONE(TIMELIB_LEVEL_VERBOSE);
+    for (std::size_t divisor = 2; divisor * divisor <= value; ++divisor) {
+        TIMELIB_COUNTER(TIMELIB_LEVEL_VERBOSE, "divisions", 1);
+        if ((value % divisor) == 0) {
+            return false;
+        }
+    }
+    return value > 1;
+}
+
+auto test_find_primes(std::size_t limit) -> std::vector<std::size_t>
+{
+    TIMELIB_ZONE(TIMELIB_LEVEL_FINE);
+    TIMELIB_TRACE_SCOPE(TIMELIB_LEVEL_FINE, "find primes");
+    std::vector<std::size_t> primes;
+    for (std::size_t value = 0; value < limit; ++value) {
+        if (test_is_prime(value)) {
+            primes.push_back(value);
+        }
+    }
+    TIMELIB_COUNTER(TIMELIB_LEVEL_FINE, "primes", primes.size());
+    return primes;
+}
+
+auto test_count_primes(std::size_t limit) -> std::size_t
+{
+    TIMELIB_SCOPED_TIMER(TIMELIB_LEVEL_COARSE, "search");
+    return test_find_primes(limit).size();
+}
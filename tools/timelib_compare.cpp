@@ -0,0 +1,91 @@
+/// @file timelib_compare.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Compares benchmark results against a baseline, and fails on regressions.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+/// Usage: timelib_compare <baseline.json> <current.json> [--threshold=<percent>] [--alpha=<p>]
+///                        [--test=<mann-whitney|welch>]
+///
+/// Exit codes: 0 when no benchmark regressed, 1 when at least one regressed, 2 on errors.
+
+#include "timelib/report.hpp"
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void print_usage(const char *program)
+{
+    std::cerr << "Usage: " << program << " <baseline.json> <current.json> [options]\n"
+              << "Options:\n"
+              << "    --threshold=<percent>          slowdown tolerated before a regression (default 5)\n"
+              << "    --alpha=<p>                    significance level (default 0.05)\n"
+              << "    --test=<mann-whitney|welch>    hypothesis test (default mann-whitney)\n";
+}
+
+static auto starts_with(const std::string &text, const std::string &prefix) -> bool
+{
+    return text.compare(0, prefix.size(), prefix) == 0;
+}
+
+static auto parse_number(const std::string &text, double &value) -> bool
+{
+    char *end = nullptr;
+    value     = std::strtod(text.c_str(), &end);
+    return !text.empty() && !std::isspace(static_cast<unsigned char>(text[0])) &&
+           (end == (text.c_str() + text.size())) && std::isfinite(value);
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> paths;
+    timelib::baseline_options_t options;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument(argv[i]);
+        bool valid = true;
+        if (starts_with(argument, "--threshold=")) {
+            valid = parse_number(argument.substr(12), options.threshold);
+        } else if (starts_with(argument, "--alpha=")) {
+            valid = parse_number(argument.substr(8), options.alpha);
+        } else if (argument == "--test=welch") {
+            options.test = timelib::welch;
+        } else if (argument == "--test=mann-whitney") {
+            options.test = timelib::mann_whitney;
+        } else if (starts_with(argument, "--")) {
+            print_usage(argv[0]);
+            return 2;
+        } else {
+            paths.push_back(argument);
+        }
+        if (!valid) {
+            std::cerr << "Error: invalid value in '" << argument << "'.\n";
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (paths.size() != 2) {
+        print_usage(argv[0]);
+        return 2;
+    }
+    try {
+        timelib::report_t baseline = timelib::report_t::load(paths[0]);
+        timelib::report_t current  = timelib::report_t::load(paths[1]);
+
+        timelib::baseline_comparison_t comparison = timelib::compare_to_baseline(baseline, current, options);
+        std::cout << comparison;
+        if (comparison.has_regressions()) {
+            std::cout << "Performance regressions detected.\n";
+            return 1;
+        }
+        std::cout << "No performance regressions.\n";
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+/// @file timelib_history.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Keeps a history of benchmark results, detects the changes, and charts the trends.
+/// @copyright (c) 2024 This file is distributed under the MIT License.
+/// See LICENSE.md for details.
+///
+/// Usage: timelib_history append <history.jsonl> <report.json> [--label=<text>]
+///        timelib_history show <history.jsonl> [--filter=<regex>] [--width=<runs>] [--height=<rows>]
+///        timelib_history html <history.jsonl> <output.html> [--filter=<regex>]
+///
+/// Exit codes: 0 on success, 2 on errors.
+
+#include "timelib/history.hpp"
+
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+
+static void print_usage(const char *program)
+{
+    std::cerr << "Usage: " << program << " append <history.jsonl> <report.json> [options]\n"
+              << "       " << program << " show <history.jsonl> [options]\n"
+              << "       " << program << " html <history.jsonl> <output.html> [options]\n"
+              << "Options:\n"
+              << "    --label=<text>                 label of the appended run (e.g., the commit)\n"
+              << "    --filter=<regex>               show only the benchmarks whose name matches\n"
+              << "    --threshold=<percent>          smallest change reported (default 5)\n"
+              << "    --alpha=<p>                    significance level of a change (default 0.001)\n"
+              << "    --width=<runs>                 last runs drawn by show, at least 1 (default 60)\n"
+              << "    --height=<rows>                rows of the charts drawn by show, at least 2 (default 10)\n";
+}
+
+static auto starts_with(const std::string &text, const std::string &prefix) -> bool
+{
+    return text.compare(0, prefix.size(), prefix) == 0;
+}
+
+static auto parse_number(const std::string &text, double &value) -> bool
+{
+    char *end = nullptr;
+    value     = std::strtod(text.c_str(), &end);
+    return !text.empty() && !std::isspace(static_cast<unsigned char>(text[0])) &&
+           (end == (text.c_str() + text.size())) && std::isfinite(value);
+}
+
+static auto parse_size(const std::string &text, std::size_t &value) -> bool
+{
+    char *end = nullptr;
+    errno     = 0;
+    value     = static_cast<std::size_t>(std::strtoul(text.c_str(), &end, 10));
+    return !text.empty() && (text[0] >= '0') && (text[0] <= '9') && (end == (text.c_str() + text.size())) &&
+           (errno != ERANGE);
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> paths;
+    std::string label;
+    std::string filter(".*");
+    std::size_t width  = 60;
+    std::size_t height = 10;
+    timelib::change_point_options_t options;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument(argv[i]);
+        bool valid = true;
+        if (starts_with(argument, "--label=")) {
+            label = argument.substr(8);
+        } else if (starts_with(argument, "--filter=")) {
+            filter = argument.substr(9);
+        } else if (starts_with(argument, "--threshold=")) {
+            valid = parse_number(argument.substr(12), options.threshold);
+        } else if (starts_with(argument, "--alpha=")) {
+            valid = parse_number(argument.substr(8), options.alpha);
+        } else if (starts_with(argument, "--width=")) {
+            valid = parse_size(argument.substr(8), width) && (width > 0);
+        } else if (starts_with(argument, "--height=")) {
+            valid = parse_size(argument.substr(9), height) && (height > 1);
+        } else if (starts_with(argument, "--")) {
+            print_usage(argv[0]);
+            return 2;
+        } else {
+            paths.push_back(argument);
+        }
+        if (!valid) {
+            std::cerr << "Error: invalid value in '" << argument << "'.\n";
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    bool valid = !paths.empty() && (((paths[0] == "append") && (paths.size() == 3)) ||
+                                    ((paths[0] == "show") && (paths.size() == 2)) ||
+                                    ((paths[0] == "html") && (paths.size() == 3)));
+    if (!valid) {
+        print_usage(argv[0]);
+        return 2;
+    }
+    try {
+        if (paths[0] == "append") {
+            timelib::history_run_t run = timelib::history_run_t::from_report(timelib::report_t::load(paths[2]), label);
+            timelib::append_history(paths[1], run);
+            std::cout << "Appended " << run.points.size() << " benchmarks to '" << paths[1] << "'.\n";
+            return 0;
+        }
+        std::vector<timelib::history_run_t> runs = timelib::load_history(paths[1]);
+        std::regex pattern(filter);
+        std::vector<timelib::history_series_t> series;
+        for (const auto &name : timelib::history_names(runs)) {
+            if (std::regex_search(name, pattern)) {
+                series.push_back(timelib::history_series(runs, name, options));
+            }
+        }
+        if (paths[0] == "show") {
+            for (const auto &serie : series) {
+                std::cout << serie.to_ascii(width, height) << "\n";
+            }
+            return 0;
+        }
+        std::ofstream file(paths[2].c_str());
+        if (!(file << timelib::render_history_html(series))) {
+            std::cerr << "Error: cannot write '" << paths[2] << "'.\n";
+            return 2;
+        }
+        std::cout << "Wrote " << series.size() << " charts to '" << paths[2] << "'.\n";
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 2;
+    }
+    return 0;
+}